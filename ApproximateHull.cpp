@@ -0,0 +1,139 @@
+#include "ApproximateHull.h"
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+
+#define PI 3.14159265358979323846
+#define FILTER_BLOCK 256
+
+ApproximateHull::ApproximateHull(int directions) {
+	k = std::max(8, (std::min(directions, APPROXIMATE_HULL_MAX_DIRECTIONS) + 7) / 8 * 8);
+	cosines.resize(k);
+	sines.resize(k);
+	extent.assign(k, -DBL_MAX);
+	extremeX.assign(k, 0);
+	extremeY.assign(k, 0);
+	updateFilter();
+
+	for (int i = 0; i < k; i++) {
+		cosines[i] = cos(2 * PI * i / k);
+		sines[i] = sin(2 * PI * i / k);
+	}
+}
+
+int ApproximateHull::directionsFor(double epsilon) {
+	// diameter / 2 * tan(pi / k) <= epsilon * diameter
+	if (!(epsilon > 0))
+		return 0;
+	return (int)std::min((double)APPROXIMATE_HULL_MAX_DIRECTIONS, ceil(PI / atan(2 * epsilon)));
+}
+
+/* The octagon of the extremes in directions 0, k/8, 2k/8, ... as eight inequalities
+ * nx * x + ny * y > c. Neighbouring extremes are often the same point, so the octagon can have
+ * fewer sides; those edges always pass, and with fewer than three sides nothing is inside. */
+void ApproximateHull::updateFilter() {
+	int step = k / 8, sides = 0;
+	for (int j = 0; j < 8; j++) {
+		int a = j * step, b = (j + 1) % 8 * step;
+		filterX[j] = -(extremeY[b] - extremeY[a]);
+		filterY[j] = extremeX[b] - extremeX[a];
+		filterC[j] = filterX[j] * extremeX[a] + filterY[j] * extremeY[a];
+		if (filterX[j] == 0 && filterY[j] == 0)
+			filterC[j] = -1;
+		else
+			sides++;
+	}
+	if (sides < 3)
+		filterC[0] = DBL_MAX;
+}
+
+void ApproximateHull::add(const struct point *points, size_t count) {
+	double *c = cosines.data(), *s = sines.data(), *e = extent.data();
+	double *ex = extremeX.data(), *ey = extremeY.data();
+	bool inside[FILTER_BLOCK];
+
+	for (size_t block = 0; block < count; block += FILTER_BLOCK) {
+		int size = (int)std::min((size_t)FILTER_BLOCK, count - block);
+		const struct point *p = points + block;
+
+		/* Everything in the octagon of what has been seen so far can't be extreme, and that stays
+		 * true as the octagon grows, so the whole block is filtered up front */
+		for (int n = 0; n < size; n++) {
+			bool in = true;
+			for (int j = 0; j < 8; j++)
+				in &= filterX[j] * p[n].x + filterY[j] * p[n].y > filterC[j];
+			inside[n] = in;
+		}
+
+		for (int n = 0; n < size; n++) {
+			if (inside[n])
+				continue;
+
+			double x = p[n].x, y = p[n].y;
+			bool changed = false;
+			for (int i = 0; i < k; i++) {
+				double d = x * c[i] + y * s[i];
+				bool better = d > e[i];
+				changed |= better;
+				e[i] = better ? d : e[i];
+				ex[i] = better ? x : ex[i];
+				ey[i] = better ? y : ey[i];
+			}
+			if (changed)
+				updateFilter();
+		}
+	}
+}
+
+void ApproximateHull::merge(const ApproximateHull &other) {
+	if (other.k != k)
+		return;
+
+	for (int i = 0; i < k; i++) {
+		if (other.extent[i] > extent[i]) {
+			extent[i] = other.extent[i];
+			extremeX[i] = other.extremeX[i];
+			extremeY[i] = other.extremeY[i];
+		}
+	}
+	updateFilter();
+}
+
+/* The extremes come out counter-clockwise as the direction turns */
+std::vector<struct point> ApproximateHull::hull() {
+	std::vector<struct point> extremes;
+	if (extent[0] == -DBL_MAX)
+		return extremes;
+
+	for (int i = 0; i < k; i++)
+		extremes.push_back({ extremeX[i], extremeY[i] });
+
+	std::vector<struct point> polygon = strictConvexPolygon(&extremes);
+	startAtBottom(&polygon);
+	return polygon;
+}
+
+/* The true hull is inside the polygon bounded by the k support lines. Between two neighbouring
+ * extremes that polygon adds a triangle whose far corner is where the two lines meet, so the
+ * error is at most the largest distance from such a corner to the segment between the extremes. */
+double ApproximateHull::errorBound() {
+	double bound = 0;
+	if (extent[0] == -DBL_MAX)
+		return bound;
+
+	for (int i = 0; i < k; i++) {
+		int j = (i + 1) % k;
+		double determinant = cosines[i] * sines[j] - sines[i] * cosines[j];
+		struct point corner = {
+			(extent[i] * sines[j] - extent[j] * sines[i]) / determinant,
+			(cosines[i] * extent[j] - cosines[j] * extent[i]) / determinant
+		};
+
+		struct point a = { extremeX[i], extremeY[i] }, b = { extremeX[j], extremeY[j] };
+		double length = (b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y);
+		double t = length > 0 ? ((corner.x - a.x) * (b.x - a.x) + (corner.y - a.y) * (b.y - a.y)) / length : 0;
+		t = std::max(0.0, std::min(1.0, t));
+		bound = std::max(bound, hypot(corner.x - (a.x + (b.x - a.x) * t), corner.y - (a.y + (b.y - a.y) * t)));
+	}
+	return bound;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <stddef.h>
+#include "DataTypes.h"
+
+/* Approximate hull from the extreme points in k evenly spaced directions, built in one
+ * streaming pass so the input never has to be held in memory at once.
+ * Points arrive in blocks through add(). A point strictly inside the octagon of the current
+ * extremes in 8 of the directions can't be extreme in any direction and is dropped after
+ * 8 multiply-adds; on large inputs almost every point is. The rest update all k directions.
+ * Both loops are branch-free over flat arrays, so the compiler can vectorize them.
+ * Streams filled on separate threads can be combined with merge(), as
+ * ConvexHull::approximateHull does.
+ *
+ * The result is inside the true hull, and every point of the true hull is within
+ * errorBound() of it (the Hausdorff distance). A priori, with k directions that bound is at most
+ * diameter / 2 * tan(pi / k); directionsFor picks k for a bound relative to the diameter.
+ * Points that get past the filter cost k multiply-adds each, so k is capped where that stops
+ * being cheaper than sorting the points for an exact hull.
+ */
+
+#define APPROXIMATE_HULL_MAX_DIRECTIONS 1024
+class ApproximateHull
+{
+private:
+	int k;
+	std::vector<double> cosines, sines;
+	std::vector<double> extent;			// largest dot product seen in each direction
+	std::vector<double> extremeX, extremeY;
+	double filterX[8], filterY[8], filterC[8];
+
+	void updateFilter();
+public:
+	/* directions is rounded up to a multiple of 8 and capped at APPROXIMATE_HULL_MAX_DIRECTIONS */
+	ApproximateHull(int directions);
+
+	/* Directions needed for a Hausdorff error of at most epsilon * diameter, or 0 if epsilon
+	 * isn't positive. The cap meets epsilon down to about 1.5e-3; below that the bound is only
+	 * as good as errorBound() reports. */
+	static int directionsFor(double epsilon);
+
+	void add(const struct point *points, size_t count);
+	void merge(const ApproximateHull &other);
+
+	/* Counter-clockwise from the bottommost point, like getHull */
+	std::vector<struct point> hull();
+	double errorBound();
+	int directions() const { return k; }
+};
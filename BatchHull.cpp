@@ -0,0 +1,198 @@
+#include "BatchHull.h"
+#include "ConvexHull.h"
+#include <math.h>
+#include <string.h>
+#include <thread>
+#include <algorithm>
+
+// Fewer sets than this per thread aren't worth starting a thread for
+#define MIN_SETS_PER_THREAD 4096
+
+struct comparator {
+	int i, j;
+};
+
+/* Batcher's odd-even merge sort for BATCH_HULL_MAX_POINTS inputs, with the comparators that
+ * reach past n left out. Padding is +infinity, which no comparator ever moves down, so the
+ * ones touching the padding would do nothing anyway. Built once per n. */
+static const std::vector<struct comparator> &sortingNetwork(int n) {
+	static const std::vector<std::vector<struct comparator>> networks = [] {
+		std::vector<std::vector<struct comparator>> all(BATCH_HULL_MAX_POINTS + 1);
+		for (int p = 1; p < BATCH_HULL_MAX_POINTS; p *= 2) {
+			for (int k = p; k >= 1; k /= 2) {
+				for (int j = k % p; j + k < BATCH_HULL_MAX_POINTS; j += 2 * k) {
+					for (int i = 0; i < k && i + j + k < BATCH_HULL_MAX_POINTS; i++) {
+						if ((i + j) / (2 * p) != (i + j + k) / (2 * p))
+							continue;
+						for (int size = i + j + k + 1; size <= BATCH_HULL_MAX_POINTS; size++)
+							all[size].push_back({ i + j, i + j + k });
+					}
+				}
+			}
+		}
+		return all;
+	}();
+	return networks[n];
+}
+
+static double cross(struct point o, struct point a, struct point b) {
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+/* Andrew's monotone chain over points already sorted by x then y. Writes the hull
+ * counter-clockwise from the bottommost vertex to out and returns its size. */
+static int chainSorted(const struct point *sorted, int n, struct point *out) {
+	if (n <= 1) {
+		if (n == 1)
+			out[0] = sorted[0];
+		return n;
+	}
+
+	struct point chain[2 * BATCH_HULL_MAX_POINTS + 1];
+	int k = 0;
+	for (int i = 0; i < n; i++) {
+		while (k >= 2 && cross(chain[k - 2], chain[k - 1], sorted[i]) <= 0)
+			k--;
+		chain[k++] = sorted[i];
+	}
+	for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+		while (k >= lower && cross(chain[k - 2], chain[k - 1], sorted[i]) <= 0)
+			k--;
+		chain[k++] = sorted[i];
+	}
+	int size = k - 1;
+
+	// All points equal: the chain is the one point twice
+	if (size == 2 && chain[0].x == chain[1].x && chain[0].y == chain[1].y)
+		size = 1;
+
+	int first = 0;
+	for (int i = 1; i < size; i++) {
+		if (chain[i].y < chain[first].y || (chain[i].y == chain[first].y && chain[i].x < chain[first].x))
+			first = i;
+	}
+	for (int i = 0; i < size; i++)
+		out[i] = chain[(first + i) % size];
+	return size;
+}
+
+/* Hulls up to BATCH_HULL_LANES sets of at most BATCH_HULL_MAX_POINTS points each. The hull of
+ * sets[l] is written over its own slot of out, which has room since a hull is never larger
+ * than its set. */
+static void hullLanes(const struct point *points, const int *offsets, const int *sets, int lanes,
+	struct point *out, int *sizes) {
+	double x[BATCH_HULL_MAX_POINTS][BATCH_HULL_LANES];
+	double y[BATCH_HULL_MAX_POINTS][BATCH_HULL_LANES];
+	int count[BATCH_HULL_LANES];
+
+	int n = 0;
+	for (int l = 0; l < BATCH_HULL_LANES; l++) {
+		count[l] = l < lanes ? offsets[sets[l] + 1] - offsets[sets[l]] : 0;
+		n = std::max(n, count[l]);
+	}
+
+	for (int i = 0; i < n; i++) {
+		for (int l = 0; l < BATCH_HULL_LANES; l++) {
+			bool present = i < count[l];
+			const struct point &p = points[present ? offsets[sets[l]] + i : 0];
+			x[i][l] = present ? p.x : INFINITY;
+			y[i][l] = present ? p.y : INFINITY;
+		}
+	}
+
+	/* Every lane takes the same comparators, so the inner loop has no branches. The network
+	 * orders by x alone, which min and max do directly, and y follows its x. The results go
+	 * through locals so the compiler needn't worry that rows i and j overlap. */
+	const std::vector<struct comparator> &network = sortingNetwork(n);
+	for (int c = 0; c < network.size(); c++) {
+		double *xi = x[network[c].i], *yi = y[network[c].i];
+		double *xj = x[network[c].j], *yj = y[network[c].j];
+		double lowX[BATCH_HULL_LANES], lowY[BATCH_HULL_LANES], highX[BATCH_HULL_LANES], highY[BATCH_HULL_LANES];
+		for (int l = 0; l < BATCH_HULL_LANES; l++) {
+			bool swap = xj[l] < xi[l];
+			lowY[l] = swap ? yj[l] : yi[l];
+			highY[l] = swap ? yi[l] : yj[l];
+			lowX[l] = std::min(xi[l], xj[l]);
+			highX[l] = std::max(xi[l], xj[l]);
+		}
+		memcpy(xi, lowX, sizeof(lowX));
+		memcpy(xj, highX, sizeof(highX));
+		memcpy(yi, lowY, sizeof(lowY));
+		memcpy(yj, highY, sizeof(highY));
+	}
+
+	struct point sorted[BATCH_HULL_MAX_POINTS];
+	for (int l = 0; l < lanes; l++) {
+		for (int i = 0; i < count[l]; i++) {
+			// Points with the same x can still be out of order by y
+			struct point p = { x[i][l], y[i][l] };
+			int j = i;
+			for (; j > 0 && sorted[j - 1].x == p.x && sorted[j - 1].y > p.y; j--)
+				sorted[j] = sorted[j - 1];
+			sorted[j] = p;
+		}
+		sizes[sets[l]] = chainSorted(sorted, count[l], out + offsets[sets[l]]);
+	}
+}
+
+void batchHulls(const std::vector<struct point> &points, const std::vector<int> &offsets, struct hullBatch *result, int threads) {
+	int setCount = std::max(0, (int)offsets.size() - 1);
+	std::vector<struct point> scratch(points.size());
+	std::vector<int> sizes(setCount);
+
+	/* Sets sorted by size with a counting sort, so the sets sharing a network are about as long
+	 * and little of it is spent on padding. The large ones go last. */
+	std::vector<int> bucketStart(BATCH_HULL_MAX_POINTS + 3, 0);
+	for (int s = 0; s < setCount; s++)
+		bucketStart[std::min(offsets[s + 1] - offsets[s], BATCH_HULL_MAX_POINTS + 1) + 1]++;
+	for (int b = 1; b < bucketStart.size(); b++)
+		bucketStart[b] += bucketStart[b - 1];
+	std::vector<int> order(setCount);
+	for (int s = 0; s < setCount; s++)
+		order[bucketStart[std::min(offsets[s + 1] - offsets[s], BATCH_HULL_MAX_POINTS + 1)]++] = s;
+	int smallSets = bucketStart[BATCH_HULL_MAX_POINTS];
+
+	auto work = [&](int begin, int end) {
+		int g = begin;
+		while (g < end) {
+			if (g >= smallSets) {
+				int s = order[g++];
+				std::vector<struct point> set(points.begin() + offsets[s], points.begin() + offsets[s + 1]);
+				std::vector<struct point> chain = monotoneChainHull(set);
+				std::vector<struct point> hull = strictConvexPolygon(&chain);
+				startAtBottom(&hull);
+				std::copy(hull.begin(), hull.end(), scratch.begin() + offsets[s]);
+				sizes[s] = hull.size();
+				continue;
+			}
+
+			int lanes = std::min(BATCH_HULL_LANES, std::min(end, smallSets) - g);
+			hullLanes(points.data(), offsets.data(), &order[g], lanes, scratch.data(), sizes.data());
+			g += lanes;
+		}
+	};
+
+	if (threads <= 0)
+		threads = std::max(1, (int)std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, setCount / MIN_SETS_PER_THREAD));
+
+	// Ranges start on a multiple of the lane count so the groups don't depend on the thread count
+	std::vector<std::thread> workers;
+	auto rangeStart = [&](int t) {
+		return (int)((long long)setCount * t / threads) / BATCH_HULL_LANES * BATCH_HULL_LANES;
+	};
+	for (int t = 1; t < threads; t++)
+		workers.push_back(std::thread(work, rangeStart(t), t + 1 < threads ? rangeStart(t + 1) : setCount));
+	work(0, threads > 1 ? rangeStart(1) : setCount);
+	for (int t = 0; t < workers.size(); t++)
+		workers[t].join();
+
+	// Packs the hulls, which are still at the offsets of their sets
+	result->offsets.resize(setCount + 1);
+	result->offsets[0] = 0;
+	for (int s = 0; s < setCount; s++)
+		result->offsets[s + 1] = result->offsets[s] + sizes[s];
+	result->points.resize(result->offsets[setCount]);
+	for (int s = 0; s < setCount; s++)
+		std::copy(scratch.begin() + offsets[s], scratch.begin() + offsets[s] + sizes[s], result->points.begin() + result->offsets[s]);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+#include "DataTypes.h"
+
+/* Hulls of many small, independent point sets in one call, without a ConvexHull, vector or
+ * heap block per set.
+ * The sets come packed back to back with an offsets array, and the hulls go out the same way.
+ * Sets are bucketed by size and taken BATCH_HULL_LANES at a time: their points are transposed
+ * into columns, one lane per set, padded to the same length with +infinity, and sorted by x with
+ * one shared sorting network whose compare-exchanges are branch-free across the lanes, so the
+ * compiler can vectorize them. Each lane then settles ties in x by y and runs a monotone chain
+ * over its sorted column.
+ * Sets larger than BATCH_HULL_MAX_POINTS are hulled one at a time with monotoneChainHull.
+ */
+
+#define BATCH_HULL_MAX_POINTS 32
+#define BATCH_HULL_LANES 8
+
+struct hullBatch {
+	std::vector<struct point> points;	// the hulls back to back
+	std::vector<int> offsets;			// hull s is points[offsets[s], offsets[s + 1])
+};
+
+/* Set s is points[offsets[s], offsets[s + 1]), so offsets has one more entry than there are sets.
+ * Each hull is counter-clockwise from its bottommost vertex like getHull, without repeated or
+ * collinear vertices. threads is the most threads to use, 0 for one per core. */
+void batchHulls(const std::vector<struct point> &points, const std::vector<int> &offsets, struct hullBatch *result, int threads = 0);
@@ -0,0 +1,163 @@
+#include "CollisionWorld.h"
+#include "GJK.h"
+#include <float.h>
+#include <thread>
+#include <functional>
+#include <algorithm>
+
+// Fewer items than this per thread aren't worth starting a thread for
+#define MIN_ITEMS_PER_THREAD 256
+
+CollisionWorld::CollisionWorld(int threads) {
+	if (threads <= 0)
+		threads = std::max(1, (int)std::thread::hardware_concurrency());
+	this->threads = threads;
+}
+
+struct aabb CollisionWorld::bounds(ConvexHull *hull) {
+	std::vector<struct point> *points = hull->getHull();
+	struct aabb box = { DBL_MAX, DBL_MAX, -DBL_MAX, -DBL_MAX };
+
+	for (int i = 0; i < points->size(); i++) {
+		box.minX = std::min(box.minX, (*points)[i].x);
+		box.minY = std::min(box.minY, (*points)[i].y);
+		box.maxX = std::max(box.maxX, (*points)[i].x);
+		box.maxY = std::max(box.maxY, (*points)[i].y);
+	}
+	return box;
+}
+
+/* Builds the hull up front as well, so the threads in step only ever read it */
+int CollisionWorld::add(ConvexHull *hull) {
+	int id;
+	if (freeIds.size() > 0) {
+		id = freeIds.back();
+		freeIds.pop_back();
+	}
+	else {
+		id = bodies.size();
+		bodies.push_back({ NULL, { 0, 0, 0, 0 }, false });
+	}
+
+	bodies[id] = { hull, bounds(hull), true };
+	order.push_back(id);
+	return id;
+}
+
+void CollisionWorld::update(int id, ConvexHull *hull) {
+	if (id < 0 || id >= bodies.size() || !bodies[id].present)
+		return;
+
+	bodies[id].hull = hull;
+	bodies[id].bounds = bounds(hull);
+}
+
+void CollisionWorld::remove(int id) {
+	if (id < 0 || id >= bodies.size() || !bodies[id].present)
+		return;
+
+	bodies[id].present = false;
+	bodies[id].hull = NULL;
+	order.erase(std::find(order.begin(), order.end(), id));
+	freeIds.push_back(id);
+}
+
+void CollisionWorld::clear() {
+	bodies.clear();
+	freeIds.clear();
+	order.clear();
+}
+
+ConvexHull *CollisionWorld::get(int id) {
+	if (id < 0 || id >= bodies.size() || !bodies[id].present)
+		return NULL;
+	return bodies[id].hull;
+}
+
+int CollisionWorld::size() {
+	return order.size();
+}
+
+/* Insertion sort: bodies barely move between steps, so the order is nearly sorted already */
+void CollisionWorld::sortOrder() {
+	for (int i = 1; i < order.size(); i++) {
+		int id = order[i];
+		double minX = bodies[id].bounds.minX;
+		int j = i - 1;
+		while (j >= 0 && bodies[order[j]].bounds.minX > minX) {
+			order[j + 1] = order[j];
+			j--;
+		}
+		order[j + 1] = id;
+	}
+}
+
+/* Pairs every body in order[begin, end) with the bodies after it whose boxes overlap its box */
+void CollisionWorld::sweep(int begin, int end, std::vector<struct collisionPair> *pairs) {
+	for (int i = begin; i < end; i++) {
+		int id = order[i];
+		struct aabb box = bodies[id].bounds;
+
+		for (int j = i + 1; j < order.size(); j++) {
+			int other = order[j];
+			struct aabb otherBox = bodies[other].bounds;
+			if (otherBox.minX > box.maxX)
+				break;
+			if (otherBox.minY > box.maxY || otherBox.maxY < box.minY)
+				continue;
+
+			pairs->push_back({ std::min(id, other), std::max(id, other) });
+		}
+	}
+}
+
+/* Splits [0, count) into contiguous ranges and runs work on each, one range per thread */
+static void parallelFor(int count, int threads, std::function<void(int range, int begin, int end)> work, int *ranges) {
+	int n = std::max(1, std::min(threads, count / MIN_ITEMS_PER_THREAD));
+	*ranges = n;
+	if (n == 1) {
+		work(0, 0, count);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	for (int r = 1; r < n; r++)
+		workers.push_back(std::thread(work, r, (int)((long long)count * r / n), (int)((long long)count * (r + 1) / n)));
+	work(0, 0, count / n);
+
+	for (int r = 0; r < workers.size(); r++)
+		workers[r].join();
+}
+
+void CollisionWorld::step(std::vector<struct collisionPair> *candidates, std::vector<struct collisionPair> *contacts) {
+	sortOrder();
+
+	// Broad phase, each range into its own list so the threads never share a vector
+	std::vector<std::vector<struct collisionPair>> rangePairs(threads);
+	int ranges;
+	parallelFor(order.size(), threads, [&](int range, int begin, int end) {
+		sweep(begin, end, &rangePairs[range]);
+	}, &ranges);
+
+	std::vector<struct collisionPair> pairs;
+	for (int r = 0; r < ranges; r++)
+		pairs.insert(pairs.end(), rangePairs[r].begin(), rangePairs[r].end());
+
+	// Narrow phase
+	if (contacts) {
+		std::vector<char> hit(pairs.size());
+		parallelFor(pairs.size(), threads, [&](int /* range */, int begin, int end) {
+			for (int i = begin; i < end; i++)
+				hit[i] = gjkIntersect(bodies[pairs[i].a].hull, bodies[pairs[i].b].hull);
+		}, &ranges);
+
+		contacts->clear();
+		for (int i = 0; i < pairs.size(); i++) {
+			if (hit[i])
+				contacts->push_back(pairs[i]);
+		}
+	}
+
+	if (candidates)
+		candidates->swap(pairs);
+}
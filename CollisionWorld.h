@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include "DataTypes.h"
+#include "ConvexHull.h"
+
+/* Finds the intersecting pairs among many hulls.
+ * The broad phase is sweep-and-prune: bodies are kept sorted by the left edge of their cached
+ * bounding box, and each body is only paired with the bodies that start before its right edge
+ * and also overlap it on y. Only those candidate pairs go through GJK.
+ * Bodies move a little between steps, so the sort order is repaired with an insertion sort,
+ * which is close to linear on nearly sorted input. Both the sweep and the narrow phase are
+ * split across threads; the results come out in the same order regardless of thread count.
+ * The world doesn't own the hulls. add and update build each hull before the threads in step
+ * read it; a hull is only safe to read from several threads at once once built, so a hull must
+ * not be swapped for an unbuilt one, or have its points changed, without calling update.
+ */
+
+struct aabb {
+	double minX, minY, maxX, maxY;
+};
+
+struct collisionPair {
+	int a, b;		// body ids, a < b
+};
+
+class CollisionWorld
+{
+private:
+	struct body {
+		ConvexHull *hull;
+		struct aabb bounds;
+		bool present;
+	};
+
+	std::vector<struct body> bodies;	// indexed by id
+	std::vector<int> freeIds;
+	std::vector<int> order;				// ids of present bodies, sorted by bounds.minX
+	int threads;
+
+	static struct aabb bounds(ConvexHull *hull);
+	void sortOrder();
+	void sweep(int begin, int end, std::vector<struct collisionPair> *pairs);
+public:
+	/* threads is the most threads a step may use, 0 for one per core */
+	CollisionWorld(int threads = 0);
+
+	int add(ConvexHull *hull);
+	/* Call after a body's hull is replaced or moved */
+	void update(int id, ConvexHull *hull);
+	void remove(int id);
+	void clear();
+
+	ConvexHull *get(int id);
+	int size();
+
+	/* Fills candidates with the broad phase pairs and contacts with the ones GJK confirms.
+	 * Either may be NULL. */
+	void step(std::vector<struct collisionPair> *candidates, std::vector<struct collisionPair> *contacts);
+};
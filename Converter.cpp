@@ -41,6 +41,10 @@ std::vector<struct point> *Converter::convertPointsToGrid(std::vector<struct poi
 	return newPoints;
 }
 
+struct point Converter::getOrigin() {
+	return origin;
+}
+
 void Converter::setOrigin(double x, double y) {
 	origin = { x, y };
 }
@@ -18,6 +18,7 @@ public:
 	std::vector<struct point> *convertPointsToScreen(std::vector<struct point> *points);
 	struct point convertPointToGrid(struct point p);
 	std::vector<struct point> *convertPointsToGrid(std::vector<struct point> *points);
+	struct point getOrigin();
 	void setOrigin(double x, double y);
 	void moveOrigin(double dx, double dy);
 	void setScale(double newScale);
@@ -1,7 +1,28 @@
 #include "ConvexHull.h"
+#include "HullProfiler.h"
+#include "ApproximateHull.h"
+#include <float.h>
+#include <algorithm>
+#include <deque>
+#include <thread>
 
-ConvexHull::ConvexHull(std::vector<struct point> points) {
+// Hulls this small are faster to scan than to search
+#define SUPPORT_SCAN_LIMIT 8
+// Steps a hinted support query climbs before giving up and searching instead
+#define SUPPORT_CLIMB_LIMIT 8
+// Fewer points than this per thread aren't worth starting a thread for in approximateHull
+#define MIN_APPROXIMATE_POINTS_PER_THREAD 65536
+
+ConvexHull::ConvexHull(std::vector<struct point> points, enum HullAlgorithm algorithm) {
 	this->pointList = points;
+	this->hull = NULL;
+	this->supportPolygon = NULL;
+	this->algorithm = algorithm;
+}
+
+ConvexHull::~ConvexHull() {
+	delete hull;
+	delete supportPolygon;
 }
 
 bool ConvexHull::contains(std::vector<struct point>* hull, struct point p) {
@@ -15,7 +36,127 @@ bool ConvexHull::contains(std::vector<struct point>* hull, struct point p) {
 
 }
 
+static double orientation(struct point o, struct point a, struct point b) {
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+static bool lessXY(struct point a, struct point b) {
+	return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+/* Andrew's monotone chain: lower and upper chains over the points sorted by x then y.
+ * Sorting is skipped when the points are already in that order. */
+std::vector<struct point> monotoneChainHull(std::vector<struct point> &points) {
+	std::vector<struct point> sortedCopy;
+	std::vector<struct point> *sorted = &points;
+	if (!std::is_sorted(points.begin(), points.end(), lessXY)) {
+		sortedCopy = points;
+		std::sort(sortedCopy.begin(), sortedCopy.end(), lessXY);
+		sorted = &sortedCopy;
+	}
+
+	int n = sorted->size();
+	if (n <= 1)
+		return *sorted;
+
+	std::vector<struct point> hull(2 * n + 1);
+	int k = 0;
+	for (int i = 0; i < n; i++) {
+		while (k >= 2 && orientation(hull[k - 2], hull[k - 1], (*sorted)[i]) <= 0)
+			k--;
+		hull[k++] = (*sorted)[i];
+	}
+	for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+		while (k >= lower && orientation(hull[k - 2], hull[k - 1], (*sorted)[i]) <= 0)
+			k--;
+		hull[k++] = (*sorted)[i];
+	}
+
+	hull.resize(std::max(0, k - 1));
+	if (hull.size() == 2 && hull[0].x == hull[1].x && hull[0].y == hull[1].y)
+		hull.pop_back();
+	startAtBottom(&hull);
+	return hull;
+}
+
+/* Melkman's algorithm for the vertices of a simple polyline, in order. The hull so far is kept
+ * in a deque with the newest vertex at both ends; a vertex inside the hull is skipped, otherwise
+ * both ends are popped until it can be pushed on each without a right turn. */
+std::vector<struct point> melkmanHull(std::vector<struct point> &points) {
+	std::vector<struct point> path;
+	for (int i = 0; i < points.size(); i++) {
+		if (path.size() == 0 || path.back().x != points[i].x || path.back().y != points[i].y)
+			path.push_back(points[i]);
+	}
+
+	// Skip ahead to the first vertex off the line through the first two; a simple polyline
+	// can only run along that line in one direction, so the ends of that stretch are its extremes
+	int third = 2;
+	while (third < path.size() && orientation(path[0], path[1], path[third]) == 0)
+		third++;
+	if (third >= path.size()) {
+		std::vector<struct point> hull;
+		if (path.size() > 0)
+			hull.push_back(*std::min_element(path.begin(), path.end(), lessXY));
+		if (path.size() > 1)
+			hull.push_back(*std::max_element(path.begin(), path.end(), lessXY));
+		startAtBottom(&hull);
+		return hull;
+	}
+
+	std::deque<struct point> deque;
+	struct point a = path[0], b = path[third - 1], c = path[third];
+	if (orientation(a, b, c) > 0)
+		deque = { c, a, b, c };
+	else
+		deque = { c, b, a, c };
+
+	for (int i = third + 1; i < path.size(); i++) {
+		struct point v = path[i];
+		int top = deque.size() - 1;
+		if (orientation(deque[0], deque[1], v) > 0 && orientation(deque[top - 1], deque[top], v) > 0)
+			continue;
+
+		while (deque.size() > 2 && orientation(deque[0], deque[1], v) <= 0)
+			deque.pop_front();
+		deque.push_front(v);
+
+		while (deque.size() > 2 && orientation(deque[deque.size() - 2], deque[deque.size() - 1], v) <= 0)
+			deque.pop_back();
+		deque.push_back(v);
+	}
+
+	std::vector<struct point> hull(deque.begin(), deque.end() - 1);
+	startAtBottom(&hull);
+	return hull;
+}
+
+void ConvexHull::setCancel(std::function<bool()> cancelled) {
+	this->cancelled = cancelled;
+}
+
+/* The points can't change after construction, so the hull is built on the first call and
+ * every later call returns the same vector */
 std::vector<struct point> *ConvexHull::getHull() {
+	if (hull)
+		return hull;
+
+	if (algorithm == HULL_MONOTONE_CHAIN) {
+		HULL_PROFILE_SCOPE("getHull/monotoneChain");
+		hull = new std::vector<struct point>(monotoneChainHull(pointList));
+		buildSupportPolygon();
+		return hull;
+	}
+	if (algorithm == HULL_MELKMAN) {
+		HULL_PROFILE_SCOPE("getHull/melkman");
+		hull = new std::vector<struct point>(melkmanHull(pointList));
+		buildSupportPolygon();
+		return hull;
+	}
+
+	HULL_PROFILE_SCOPE("getHull");
+	HULL_PROFILE_PHASES("getHull/extremePoints");
+	HULL_PROFILE_COUNT(ALLOCATIONS, 1);
 	hull = new std::vector<struct point>;
 
 	/* The topmost, rightmost, bottommost, and leftmost points in the list, in that order */
@@ -34,14 +175,24 @@ std::vector<struct point> *ConvexHull::getHull() {
 
 	for (int i = 0; i < 4; i++)
 		hull->push_back(extremePoints[i]);
+	HULL_PROFILE_COUNT(HULL_INSERTIONS, 4);
 
 	// printPoints(stdout, hull, "Extreme points");
 
+	HULL_PROFILE_NEXT_PHASE("getHull/expand");
+
 	for (int i = 1; i < hull->size() + 1; i++) {
+		if (cancelled && cancelled()) {
+			delete hull;
+			hull = NULL;
+			return NULL;
+		}
 		if (i != hull->size()) {
 			int farthestPoint = getPointFarthestFromEdge((*hull)[i - 1], (*hull)[i], &pointList);
 			if (farthestPoint != -1 && !contains(hull, pointList[farthestPoint])) {
 				hull->insert(hull->begin() + i, pointList[farthestPoint]);
+				HULL_PROFILE_COUNT(HULL_INSERTIONS, 1);
+				HULL_PROFILE_COUNT(HULL_RESCANS, 1);
 				if (i > 1)
 					i = i - 2;
 				else
@@ -52,6 +203,8 @@ std::vector<struct point> *ConvexHull::getHull() {
 			int farthestPoint = getPointFarthestFromEdge((*hull)[hull->size() - 1], (*hull)[0], &pointList);
 			if (farthestPoint != -1 && !contains(hull, pointList[farthestPoint])) {
 				hull->insert(hull->begin() + i, pointList[farthestPoint]);
+				HULL_PROFILE_COUNT(HULL_INSERTIONS, 1);
+				HULL_PROFILE_COUNT(HULL_RESCANS, 1);
 				if (i > 1)
 					i = i - 2;
 				else
@@ -60,6 +213,7 @@ std::vector<struct point> *ConvexHull::getHull() {
 		}
 	}
 
+	buildSupportPolygon();
 	return hull;
 }
 
@@ -82,8 +236,151 @@ bool ConvexHull::isPointInside(struct point p1, struct point p2, struct point te
 	return false;
 }
 
+/* Which half of the turn from the positive x axis a direction is in, for comparing angles
+ * without atan2 */
+static int angleHalf(struct vector v) {
+	return v.y < 0 || (v.y == 0 && v.x < 0) ? 1 : 0;
+}
+
+/* True if a is at a smaller angle than b, both measured counter-clockwise from the positive x
+ * axis into [0, 2 pi) */
+static bool angleLess(struct vector a, struct vector b) {
+	int ha = angleHalf(a), hb = angleHalf(b);
+	if (ha != hb)
+		return ha < hb;
+	return a.x * b.y - a.y * b.x > 0;
+}
+
+static double along(struct point p, struct vector d) {
+	return p.x * d.x + p.y * d.y;
+}
+
+static int scanSupport(std::vector<struct point> *polygon, struct vector d) {
+	int best = 0;
+	double bestDistance = -DBL_MAX;
+
+	for (int i = 0; i < polygon->size(); i++) {
+		double distance = along((*polygon)[i], d);
+		if (distance > bestDistance) {
+			best = i;
+			bestDistance = distance;
+		}
+	}
+
+	return best;
+}
+
+/* The polygon starts at its bottommost vertex, so going round it the edge directions turn
+ * from [0, pi) up to below 2 pi without wrapping. The vertex farthest along d is where the
+ * edges turn past d rotated a quarter turn counter-clockwise: the start of the first edge at a
+ * greater angle than that, or the first vertex if there is none. */
+static int searchSupport(std::vector<struct point> *polygon, struct vector d) {
+	int n = polygon->size();
+	if (n <= SUPPORT_SCAN_LIMIT)
+		return scanSupport(polygon, d);
+
+	struct vector tangent = { -d.y, d.x };
+	int low = 0, high = n;
+	while (low < high) {
+		int mid = (low + high) / 2;
+		struct vector edge = makeVectorFromPoints((*polygon)[mid], (*polygon)[mid + 1 < n ? mid + 1 : 0]);
+		if (angleLess(tangent, edge))
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	return low < n ? low : 0;
+}
+
+/* The hull without repeated or collinear vertices and starting at the bottommost, which is
+ * what the searches need. Made by running the monotone chain over the hull's vertices, which
+ * unlike strictConvexPolygon also gets the ends of a hull with no area right. It is built
+ * wherever the hull is, so once the hull is built support queries only read and can run on
+ * several threads at once. */
+void ConvexHull::buildSupportPolygon() {
+	supportPolygon = new std::vector<struct point>(monotoneChainHull(*hull));
+}
+
+std::vector<struct point> *ConvexHull::getSupportPolygon() {
+	getHull();
+	return supportPolygon;
+}
+
+/* Returns the hull vertex farthest along d. Builds the hull first if needed. */
+struct point ConvexHull::support(struct vector d) {
+	std::vector<struct point> *polygon = getSupportPolygon();
+	return (*polygon)[searchSupport(polygon, d)];
+}
+
+struct point ConvexHull::support(struct vector d, int *hint) {
+	std::vector<struct point> *polygon = getSupportPolygon();
+	int n = polygon->size();
+	if (*hint < 0 || *hint >= n || n <= 2) {
+		*hint = searchSupport(polygon, d);
+		return (*polygon)[*hint];
+	}
+
+	/* Along the boundary of a convex polygon the distance along d only rises to one maximum
+	 * and falls to one minimum, so climbing whichever way it rises ends on the farthest
+	 * vertex. Without collinear vertices neither neighbour ties with both sides. */
+	int i = *hint;
+	double distance = along((*polygon)[i], d);
+	int step = along((*polygon)[(i + 1) % n], d) > distance ? 1 : n - 1;
+	for (int steps = 0; steps < SUPPORT_CLIMB_LIMIT; steps++) {
+		int next = (i + step) % n;
+		double nextDistance = along((*polygon)[next], d);
+		if (nextDistance <= distance) {
+			*hint = i;
+			return (*polygon)[i];
+		}
+		i = next;
+		distance = nextDistance;
+	}
+
+	*hint = searchSupport(polygon, d);
+	return (*polygon)[*hint];
+}
+
+void ConvexHull::support(const std::vector<struct vector> &directions, std::vector<struct point> *points) {
+	std::vector<struct point> *polygon = getSupportPolygon();
+	int n = polygon->size();
+	points->resize(directions.size());
+
+	// A few directions are answered faster one search at a time than by sorting them
+	int logN = 1;
+	while ((1 << logN) < n)
+		logN++;
+	if (n <= SUPPORT_SCAN_LIMIT || (long long)directions.size() * logN < n) {
+		for (int i = 0; i < directions.size(); i++)
+			(*points)[i] = (*polygon)[searchSupport(polygon, directions[i])];
+		return;
+	}
+
+	std::vector<struct vector> tangents(directions.size());
+	std::vector<int> order(directions.size());
+	for (int i = 0; i < directions.size(); i++) {
+		tangents[i] = { -directions[i].y, directions[i].x };
+		// Every vertex is as far as any other along nothing, but the sort needs an angle
+		if (tangents[i].x == 0 && tangents[i].y == 0)
+			tangents[i].x = 1;
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return angleLess(tangents[a], tangents[b]); });
+
+	// The same search as searchSupport, but the directions only ever move it forwards
+	int edge = 0;
+	for (int k = 0; k < order.size(); k++) {
+		struct vector tangent = tangents[order[k]];
+		while (edge < n && !angleLess(tangent, makeVectorFromPoints((*polygon)[edge], (*polygon)[edge + 1 < n ? edge + 1 : 0])))
+			edge++;
+		(*points)[order[k]] = (*polygon)[edge < n ? edge : 0];
+	}
+}
+
 /* Returns true if the point p is inside this convex hull */
 bool ConvexHull::containsPoint(struct point p) {
+	HULL_PROFILE_COUNT(CONTAINS_TESTS, 1);
 	for (int i = 1; i < hull->size(); i++) {
 		if ((*hull)[i - 1].x != (*hull)[i].x || (*hull)[i - 1].y != (*hull)[i].y) {
 			if (!isPointInside((*hull)[i - 1], (*hull)[i], p)) {
@@ -101,15 +398,24 @@ bool ConvexHull::containsPoint(struct point p) {
 	return true;
 }
 
-static ConvexHull *minkowskiAux(ConvexHull *hull1, ConvexHull *hull2, bool sum, Converter *conv) {
+static ConvexHull *minkowskiAux(ConvexHull *hull1, ConvexHull *hull2, bool sum, Converter *conv, const std::function<bool()> &cancelled) {
+	HULL_PROFILE_SCOPE("minkowskiAux");
+	HULL_PROFILE_PHASES("minkowskiAux/hullInputs");
 	std::vector<struct point> *hull1Points = hull1->getHull();
 	std::vector<struct point> *hull2Points = hull2->getHull();
+	if (hull1Points == NULL || hull2Points == NULL)
+		return NULL;
 	std::vector<struct point> *sumPoints = new std::vector<struct point>();
+	HULL_PROFILE_COUNT(ALLOCATIONS, 1);
 
+	HULL_PROFILE_NEXT_PHASE("minkowskiAux/toGrid");
 	hull1Points = conv->convertPointsToGrid(hull1Points);
 	hull2Points = conv->convertPointsToGrid(hull2Points);
+	HULL_PROFILE_COUNT(ALLOCATIONS, 2);
 
-	for (int i = 0; i < hull1Points->size(); i++) {
+	HULL_PROFILE_NEXT_PHASE("minkowskiAux/sum");
+	bool stopped = false;
+	for (int i = 0; i < hull1Points->size() && !stopped; i++) {
 		struct point point1 = hull1Points->at(i);
 		for (int j = 0; j < hull2Points->size(); j++) {
 			struct point point2 = hull2Points->at(j);
@@ -120,24 +426,257 @@ static ConvexHull *minkowskiAux(ConvexHull *hull1, ConvexHull *hull2, bool sum,
 				newPoint = { point1.x - point2.x, point1.y - point2.y };
 			sumPoints->push_back(newPoint);
 		}
+		stopped = cancelled && cancelled();
 	}
 
-	std::vector<struct point> *newSumPoints = conv->convertPointsToScreen(sumPoints);
+	ConvexHull *newHull = NULL;
+	if (!stopped) {
+		HULL_PROFILE_NEXT_PHASE("minkowskiAux/toScreen");
+		std::vector<struct point> *newSumPoints = conv->convertPointsToScreen(sumPoints);
+		HULL_PROFILE_COUNT(ALLOCATIONS, 1);
+
+		HULL_PROFILE_NEXT_PHASE("minkowskiAux/hullSum");
+		newHull = new ConvexHull(*newSumPoints);
+		newHull->setCancel(cancelled);
+		if (newHull->getHull() == NULL) {
+			delete newHull;
+			newHull = NULL;
+		}
+		delete newSumPoints;
+	}
 
-	ConvexHull *newHull = new ConvexHull(*newSumPoints);
-	newHull->getHull();
 	delete hull1Points;
 	delete hull2Points;
 	delete sumPoints;
-	delete newSumPoints;
 
 	return newHull;
 }
 
+/* Both give up, returning NULL, if hull1 is cancelled */
 ConvexHull *ConvexHull::minkowskiSum(ConvexHull *hull1, ConvexHull *hull2, Converter *conv) {
-	return minkowskiAux(hull1, hull2, true, conv);
+	return minkowskiAux(hull1, hull2, true, conv, hull1->cancelled);
 }
 
 ConvexHull *ConvexHull::minkowskiDifference(ConvexHull *hull1, ConvexHull *hull2, Converter *conv) {
-	return minkowskiAux(hull1, hull2, false, conv);
-}
\ No newline at end of file
+	return minkowskiAux(hull1, hull2, false, conv, hull1->cancelled);
+}
+
+enum clipInside { CLIP_UNKNOWN, CLIP_P_INSIDE, CLIP_Q_INSIDE };
+
+static double turnSign(struct point o, struct point a, struct point b) {
+	double turn = (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+	return turn > 0 ? 1 : (turn < 0 ? -1 : 0);
+}
+
+/* Where the segments a-b and c-d cross, if they do at exactly one point */
+static bool segmentsCross(struct point a, struct point b, struct point c, struct point d, struct point *p) {
+	struct vector ab = makeVectorFromPoints(a, b), cd = makeVectorFromPoints(c, d), ac = makeVectorFromPoints(a, c);
+	double denominator = ab.x * cd.y - ab.y * cd.x;
+	if (denominator == 0)
+		return false;
+
+	double s = (ac.x * cd.y - ac.y * cd.x) / denominator;
+	double t = (ac.x * ab.y - ac.y * ab.x) / denominator;
+	if (s < 0 || s > 1 || t < 0 || t > 1)
+		return false;
+
+	*p = { a.x + ab.x * s, a.y + ab.y * s };
+	return true;
+}
+
+/* Accumulates the boundary of the intersection: the shoelace area always, the vertices only
+ * if they are wanted */
+struct clipOutput {
+	std::vector<struct point> *vertices;
+	struct point first, last;
+	bool empty;
+	double twiceArea;
+
+	void add(struct point p) {
+		if (empty)
+			first = p;
+		else
+			twiceArea += last.x * p.y - last.y * p.x;
+		if (vertices)
+			vertices->push_back(p);
+		last = p;
+		empty = false;
+	}
+
+	double area() {
+		return empty ? 0 : (twiceArea + last.x * first.y - last.y * first.x) / 2;
+	}
+};
+
+static struct point centroid(std::vector<struct point> &polygon) {
+	struct point c = { 0, 0 };
+	for (int i = 0; i < polygon.size(); i++) {
+		c.x += polygon[i].x / polygon.size();
+		c.y += polygon[i].y / polygon.size();
+	}
+	return c;
+}
+
+static bool strictlyInside(std::vector<struct point> &polygon, struct point p) {
+	for (int i = 0; i < polygon.size(); i++) {
+		if (turnSign(polygon[i], polygon[(i + 1) % polygon.size()], p) <= 0)
+			return false;
+	}
+	return true;
+}
+
+static double polygonArea(std::vector<struct point> &polygon) {
+	struct clipOutput output = { NULL, { 0, 0 }, { 0, 0 }, true, 0 };
+	for (int i = 0; i < polygon.size(); i++)
+		output.add(polygon[i]);
+	return output.area();
+}
+
+/* O'Rourke's convex polygon intersection: the edges of P and Q chase each other around both
+ * polygons, each step advancing whichever edge is "aiming" at the other, and every crossing
+ * or vertex passed while inside the other polygon goes on the boundary. Both polygons are
+ * walked at most twice, so this is O(|P| + |Q|). P and Q must be counter-clockwise with no
+ * repeated or collinear vertices. Returns the area of the intersection.
+ */
+static double clipConvex(std::vector<struct point> &P, std::vector<struct point> &Q, std::vector<struct point> *vertices) {
+	struct clipOutput output = { vertices, { 0, 0 }, { 0, 0 }, true, 0 };
+	int n = P.size(), m = Q.size();
+	if (n < 3 || m < 3)
+		return 0;
+
+	int a = 0, b = 0, aAdvances = 0, bAdvances = 0;
+	enum clipInside inside = CLIP_UNKNOWN;
+	bool crossed = false;
+
+	do {
+		int a1 = (a + n - 1) % n, b1 = (b + m - 1) % m;
+		struct vector A = makeVectorFromPoints(P[a1], P[a]);
+		struct vector B = makeVectorFromPoints(Q[b1], Q[b]);
+		double cross = A.x * B.y - A.y * B.x;
+		double aHB = turnSign(Q[b1], Q[b], P[a]);	// side of edge B that the head of A is on
+		double bHA = turnSign(P[a1], P[a], Q[b]);
+
+		struct point p;
+		if (segmentsCross(P[a1], P[a], Q[b1], Q[b], &p)) {
+			// Count the full loop from the first crossing
+			if (!crossed)
+				aAdvances = bAdvances = 0;
+			crossed = true;
+			output.add(p);
+			if (aHB > 0)
+				inside = CLIP_P_INSIDE;
+			else if (bHA > 0)
+				inside = CLIP_Q_INSIDE;
+		}
+
+		// Parallel edges with each outside the other: no overlap
+		if (cross == 0 && aHB < 0 && bHA < 0)
+			return 0;
+
+		bool advanceA;
+		if (cross == 0 && aHB == 0 && bHA == 0)
+			advanceA = inside != CLIP_P_INSIDE;
+		else if (cross >= 0)
+			advanceA = bHA > 0;
+		else
+			advanceA = aHB <= 0;
+
+		if (advanceA) {
+			if (inside == CLIP_P_INSIDE)
+				output.add(P[a]);
+			aAdvances++;
+			a = (a + 1) % n;
+		}
+		else {
+			if (inside == CLIP_Q_INSIDE)
+				output.add(Q[b]);
+			bAdvances++;
+			b = (b + 1) % m;
+		}
+	} while ((aAdvances < n || bAdvances < m) && aAdvances < 2 * n && bAdvances < 2 * m);
+
+	if (inside != CLIP_UNKNOWN)
+		return output.area();
+
+	/* The boundaries never crossed, so one polygon is inside the other or they are apart, and
+	 * if either centroid is inside the other polygon the smaller one is the intersection.
+	 * Centroids are tested rather than vertices, which could be on the other boundary. */
+	if (!strictlyInside(Q, centroid(P)) && !strictlyInside(P, centroid(Q)))
+		return 0;
+
+	double areaP = polygonArea(P), areaQ = polygonArea(Q);
+	if (vertices)
+		*vertices = areaP < areaQ ? P : Q;
+	return std::min(areaP, areaQ);
+}
+
+/* The intersection of the two hulls, in the same order as getHull (counter-clockwise from the
+ * bottommost point), or NULL if they don't overlap with any area */
+ConvexHull *ConvexHull::intersection(ConvexHull *hull1, ConvexHull *hull2) {
+	HULL_PROFILE_SCOPE("intersection");
+	std::vector<struct point> P = strictConvexPolygon(hull1->getHull());
+	std::vector<struct point> Q = strictConvexPolygon(hull2->getHull());
+	std::vector<struct point> boundary;
+
+	if (clipConvex(P, Q, &boundary) <= 0)
+		return NULL;
+
+	std::vector<struct point> polygon = strictConvexPolygon(&boundary);
+	if (polygon.size() < 3)
+		return NULL;
+
+	startAtBottom(&polygon);
+
+	// The vertices already form the hull, so it is filled in directly rather than recomputed
+	ConvexHull *result = new ConvexHull(polygon);
+	result->hull = new std::vector<struct point>(polygon);
+	result->buildSupportPolygon();
+	return result;
+}
+
+/* Just the area of the intersection, without building its polygon */
+double ConvexHull::intersectionArea(ConvexHull *hull1, ConvexHull *hull2) {
+	HULL_PROFILE_SCOPE("intersectionArea");
+	std::vector<struct point> P = strictConvexPolygon(hull1->getHull());
+	std::vector<struct point> Q = strictConvexPolygon(hull2->getHull());
+	return clipConvex(P, Q, NULL);
+}
+
+/* A hull within epsilon * diameter of this one, from the extremes in evenly spaced directions
+ * (see ApproximateHull), or NULL if epsilon isn't positive. The exact Hausdorff bound of the
+ * result goes in errorBound if it isn't NULL. With more than one thread each streams its own
+ * share of the points, and the streams are merged at the end. */
+ConvexHull *ConvexHull::approximateHull(double epsilon, double *errorBound, int threads) {
+	HULL_PROFILE_SCOPE("approximateHull");
+	int directions = ApproximateHull::directionsFor(epsilon);
+	if (directions == 0)
+		return NULL;
+
+	if (threads <= 0)
+		threads = std::max(1, (int)std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, (int)(pointList.size() / MIN_APPROXIMATE_POINTS_PER_THREAD)));
+
+	std::vector<ApproximateHull> streams(threads, ApproximateHull(directions));
+	auto work = [&](int t) {
+		size_t begin = pointList.size() * t / threads, end = pointList.size() * (t + 1) / threads;
+		streams[t].add(pointList.data() + begin, end - begin);
+	};
+
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; t++)
+		workers.push_back(std::thread(work, t));
+	work(0);
+	for (int t = 0; t < workers.size(); t++)
+		workers[t].join();
+	for (int t = 1; t < threads; t++)
+		streams[0].merge(streams[t]);
+
+	std::vector<struct point> polygon = streams[0].hull();
+	if (errorBound)
+		*errorBound = streams[0].errorBound();
+
+	ConvexHull *result = new ConvexHull(polygon);
+	result->hull = new std::vector<struct point>(polygon);
+	result->buildSupportPolygon();
+	return result;
+}
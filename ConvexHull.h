@@ -1,22 +1,63 @@
 #pragma once
 
 #include <vector>
+#include <functional>
 #include "DataTypes.h"
 #include "Converter.h"
 
+/* How getHull builds the hull. The points must already be in order for the last two:
+ * HULL_MONOTONE_CHAIN sorts them by x then y unless they already are, and HULL_MELKMAN needs
+ * them to trace a simple (non self-intersecting) polyline, such as a track or a contour. Both
+ * then take a single linear pass. The names are prefixed so they can't collide with the GUI's
+ * menu ids. */
+enum HullAlgorithm {
+	HULL_FARTHEST_POINT,	// grows the hull from the extreme points by farthest point insertion
+	HULL_MONOTONE_CHAIN,
+	HULL_MELKMAN
+};
+
 class ConvexHull
 {
 private:
 	std::vector<struct point> pointList;
 	std::vector<struct point> *hull;
+	std::vector<struct point> *supportPolygon;
+	enum HullAlgorithm algorithm;
+	std::function<bool()> cancelled;
+
+	void buildSupportPolygon();
+	std::vector<struct point> *getSupportPolygon();
 public:
-	ConvexHull(std::vector<struct point> points);
+	ConvexHull(std::vector<struct point> points, enum HullAlgorithm algorithm = HULL_FARTHEST_POINT);
+	~ConvexHull();
+	// Owns the vectors its pointers point to, so copies would free them twice
+	ConvexHull(const ConvexHull &) = delete;
+	ConvexHull &operator=(const ConvexHull &) = delete;
 
+	/* Lets getHull and the Minkowski operations give up partway and return NULL once
+	 * cancelled returns true. It is asked between the edges getHull grows and between the
+	 * vertices the Minkowski sum is swept over. */
+	void setCancel(std::function<bool()> cancelled);
 	std::vector<struct point> *getHull();
 	bool containsPoint(struct point p);
+	/* Support queries take O(log h) by binary search over the hull's edge directions. The
+	 * hinted version starts from the vertex the last query with the same hint ended on and
+	 * climbs from there, which is O(1) when the direction only turns a little between calls,
+	 * as it does in GJK or when tracking a rotating shape; start the hint at -1. The batch
+	 * version sorts many directions by angle and answers them all in one sweep of the hull. */
+	struct point support(struct vector d);
+	struct point support(struct vector d, int *hint);
+	void support(const std::vector<struct vector> &directions, std::vector<struct point> *points);
 	bool contains(std::vector<struct point>* hull, struct point p);
 	bool isPointInside(struct point p1, struct point p2, struct point testPoint);
 
 	ConvexHull *minkowskiSum(ConvexHull *hull1, ConvexHull *hull2, Converter *conv);
 	ConvexHull *minkowskiDifference(ConvexHull *hull1, ConvexHull *hull2, Converter *conv);
-};
\ No newline at end of file
+	ConvexHull *intersection(ConvexHull *hull1, ConvexHull *hull2);
+	double intersectionArea(ConvexHull *hull1, ConvexHull *hull2);
+	/* threads is the most threads to stream the points on, 0 for one per core */
+	ConvexHull *approximateHull(double epsilon, double *errorBound, int threads = 1);
+};
+
+std::vector<struct point> monotoneChainHull(std::vector<struct point> &points);
+std::vector<struct point> melkmanHull(std::vector<struct point> &points);
@@ -0,0 +1,459 @@
+#include "ConvexHull3D.h"
+#include "ConvexHull.h"
+#include <math.h>
+#include <float.h>
+#include <map>
+#include <thread>
+#include <algorithm>
+
+// Fewer points than this per thread aren't worth starting a thread for
+#define MIN_POINTS_PER_THREAD 16384
+
+struct halfEdge {
+	int vertex;		// where the edge starts, an index into the cloud
+	int next;		// the next edge counter-clockwise around the same face
+	int twin;		// the same edge the other way, on the neighbouring face
+	int face;
+};
+
+struct meshFace {
+	struct vector3d normal;		// unit length, pointing out
+	double offset;				// the plane is dot(normal, p) == offset
+	int edge;
+	bool alive;
+	bool visible;				// seen from the point being added
+	std::vector<int> conflicts;	// cloud points outside this face and not given to another
+};
+
+struct quickHull3d {
+	const std::vector<struct point3d> *points;
+	double tolerance;
+	int threads;
+	std::vector<struct halfEdge> edges;
+	std::vector<int> freeEdges;
+	std::vector<struct meshFace> faces;
+	std::vector<int> freeFaces;
+};
+
+static struct vector3d toVector(struct point3d p) {
+	return { p.x, p.y, p.z };
+}
+
+static double length(struct vector3d v) {
+	return sqrt(dotProduct3d(v, v));
+}
+
+static double distanceToFace(struct quickHull3d *q, int f, struct point3d p) {
+	return dotProduct3d(q->faces[f].normal, toVector(p)) - q->faces[f].offset;
+}
+
+static int allocateEdge(struct quickHull3d *q) {
+	if (q->freeEdges.size() > 0) {
+		int e = q->freeEdges.back();
+		q->freeEdges.pop_back();
+		return e;
+	}
+	q->edges.push_back({ -1, -1, -1, -1 });
+	return q->edges.size() - 1;
+}
+
+/* The triangle a, b, c, counter-clockwise seen from outside. Its first edge goes from a to b;
+ * the twins are left for the caller to link. */
+static int newFace(struct quickHull3d *q, int a, int b, int c) {
+	int f;
+	if (q->freeFaces.size() > 0) {
+		f = q->freeFaces.back();
+		q->freeFaces.pop_back();
+	}
+	else {
+		q->faces.push_back(meshFace());
+		f = q->faces.size() - 1;
+	}
+
+	int e[3] = { allocateEdge(q), allocateEdge(q), allocateEdge(q) };
+	int v[3] = { a, b, c };
+	for (int k = 0; k < 3; k++)
+		q->edges[e[k]] = { v[k], e[(k + 1) % 3], -1, f };
+
+	const std::vector<struct point3d> &points = *q->points;
+	struct vector3d normal = crossProduct3d(makeVector3dFromPoints(points[a], points[b]), makeVector3dFromPoints(points[a], points[c]));
+	double size = length(normal);
+	struct meshFace &face = q->faces[f];
+	// A sliver with no area has no direction; a zero normal keeps every point off it
+	face.normal = size > 0 ? vector3d{ normal.x / size, normal.y / size, normal.z / size } : vector3d{ 0, 0, 0 };
+	face.offset = dotProduct3d(face.normal, toVector(points[a]));
+	face.edge = e[0];
+	face.alive = true;
+	face.visible = false;
+	face.conflicts.clear();
+	return f;
+}
+
+static void freeFace(struct quickHull3d *q, int f) {
+	int e = q->faces[f].edge;
+	for (int k = 0; k < 3; k++) {
+		q->freeEdges.push_back(e);
+		e = q->edges[e].next;
+	}
+	q->faces[f].alive = false;
+	q->faces[f].conflicts.clear();
+	q->freeFaces.push_back(f);
+}
+
+/* For each of the given points, the face among candidates it is farthest outside, or -1 if it
+ * is inside them all. Split between threads when there are enough points. */
+static void assignPoints(struct quickHull3d *q, const std::vector<int> &pointIndices, const std::vector<int> &candidates, std::vector<int> *target) {
+	target->resize(pointIndices.size());
+	auto work = [&](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			struct point3d p = (*q->points)[pointIndices[i]];
+			int best = -1;
+			double bestDistance = q->tolerance;
+			for (int c = 0; c < candidates.size(); c++) {
+				double distance = distanceToFace(q, candidates[c], p);
+				if (distance > bestDistance) {
+					best = candidates[c];
+					bestDistance = distance;
+				}
+			}
+			(*target)[i] = best;
+		}
+	};
+
+	int count = pointIndices.size();
+	int threads = std::max(1, std::min(q->threads, count / MIN_POINTS_PER_THREAD));
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; t++)
+		workers.push_back(std::thread(work, (int)((long long)count * t / threads), (int)((long long)count * (t + 1) / threads)));
+	work(0, count / threads);
+	for (int t = 0; t < workers.size(); t++)
+		workers[t].join();
+}
+
+/* Marks every face visible from eye, starting from seed, which is, and returns the horizon:
+ * the edges of visible faces whose twins are on faces that aren't, in order around the loop.
+ * The walk is a depth first search which, entering a face over one edge, carries on from the
+ * next edge of that face, so the horizon comes out in order. */
+static void findHorizon(struct quickHull3d *q, struct point3d eye, int seed, std::vector<int> *visible, std::vector<int> *horizon) {
+	struct frame {
+		int first;		// the edge the face was entered by, where the walk around it stops
+		int edge;		// the next edge to look across
+		bool started;
+	};
+	std::vector<struct frame> stack;
+
+	q->faces[seed].visible = true;
+	visible->push_back(seed);
+	stack.push_back({ q->faces[seed].edge, q->faces[seed].edge, false });
+
+	while (stack.size() > 0) {
+		struct frame &top = stack.back();
+		if (top.started && top.edge == top.first) {
+			stack.pop_back();
+			continue;
+		}
+		top.started = true;
+
+		int e = top.edge;
+		top.edge = q->edges[e].next;
+		int twin = q->edges[e].twin;
+		int neighbour = q->edges[twin].face;
+		if (q->faces[neighbour].visible)
+			continue;
+
+		if (distanceToFace(q, neighbour, eye) > q->tolerance) {
+			q->faces[neighbour].visible = true;
+			visible->push_back(neighbour);
+			stack.push_back({ twin, q->edges[twin].next, true });
+		}
+		else {
+			horizon->push_back(e);
+		}
+	}
+}
+
+static void addPoint(struct quickHull3d *q, int face, std::vector<int> *pending) {
+	const std::vector<struct point3d> &points = *q->points;
+	std::vector<int> &conflicts = q->faces[face].conflicts;
+	int eyeAt = 0;
+	for (int i = 1; i < conflicts.size(); i++) {
+		if (distanceToFace(q, face, points[conflicts[i]]) > distanceToFace(q, face, points[conflicts[eyeAt]]))
+			eyeAt = i;
+	}
+	int eye = conflicts[eyeAt];
+	conflicts[eyeAt] = conflicts.back();
+	conflicts.pop_back();
+
+	std::vector<int> visible, horizon;
+	findHorizon(q, points[eye], face, &visible, &horizon);
+
+	// One new face per horizon edge, each sharing its sides with the ones before and after it
+	std::vector<int> created;
+	for (int h = 0; h < horizon.size(); h++) {
+		int e = horizon[h];
+		int from = q->edges[e].vertex, to = q->edges[q->edges[e].next].vertex;
+		int twin = q->edges[e].twin;
+		int f = newFace(q, from, to, eye);
+		int base = q->faces[f].edge;
+		q->edges[base].twin = twin;
+		q->edges[twin].twin = base;
+		created.push_back(f);
+	}
+	for (int h = 0; h < created.size(); h++) {
+		int toEye = q->edges[q->faces[created[h]].edge].next;
+		int fromEye = q->edges[q->edges[q->faces[created[(h + 1) % created.size()]].edge].next].next;
+		q->edges[toEye].twin = fromEye;
+		q->edges[fromEye].twin = toEye;
+	}
+
+	std::vector<int> orphans;
+	for (int v = 0; v < visible.size(); v++) {
+		std::vector<int> &list = q->faces[visible[v]].conflicts;
+		orphans.insert(orphans.end(), list.begin(), list.end());
+		freeFace(q, visible[v]);
+	}
+
+	std::vector<int> target;
+	assignPoints(q, orphans, created, &target);
+	for (int i = 0; i < orphans.size(); i++) {
+		if (target[i] >= 0)
+			q->faces[target[i]].conflicts.push_back(orphans[i]);
+	}
+	for (int h = 0; h < created.size(); h++) {
+		if (q->faces[created[h]].conflicts.size() > 0)
+			pending->push_back(created[h]);
+	}
+}
+
+ConvexHull3D::ConvexHull3D(std::vector<struct point3d> points, int threads) {
+	this->pointList = points;
+	this->vertices = NULL;
+	this->faces = NULL;
+	this->tolerance = 0;
+	this->flat = false;
+	this->threads = threads > 0 ? threads : std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+ConvexHull3D::~ConvexHull3D() {
+	delete vertices;
+	delete faces;
+}
+
+std::vector<struct point3d> *ConvexHull3D::getVertices() {
+	if (!vertices)
+		build();
+	return vertices;
+}
+
+std::vector<struct hullFace3d> *ConvexHull3D::getFaces() {
+	if (!faces)
+		build();
+	return faces;
+}
+
+void ConvexHull3D::build() {
+	vertices = new std::vector<struct point3d>();
+	faces = new std::vector<struct hullFace3d>();
+	const std::vector<struct point3d> &points = pointList;
+	int n = points.size();
+	if (n == 0)
+		return;
+
+	// The six extreme points, and a tolerance for rounding in the plane tests scaled to the cloud
+	int extremes[6] = { 0, 0, 0, 0, 0, 0 };
+	double maxX = 0, maxY = 0, maxZ = 0;
+	for (int i = 0; i < n; i++) {
+		if (points[i].x < points[extremes[0]].x) extremes[0] = i;
+		if (points[i].x > points[extremes[1]].x) extremes[1] = i;
+		if (points[i].y < points[extremes[2]].y) extremes[2] = i;
+		if (points[i].y > points[extremes[3]].y) extremes[3] = i;
+		if (points[i].z < points[extremes[4]].z) extremes[4] = i;
+		if (points[i].z > points[extremes[5]].z) extremes[5] = i;
+		maxX = std::max(maxX, fabs(points[i].x));
+		maxY = std::max(maxY, fabs(points[i].y));
+		maxZ = std::max(maxZ, fabs(points[i].z));
+	}
+	tolerance = 3 * DBL_EPSILON * (maxX + maxY + maxZ);
+
+	// The starting tetrahedron: the farthest apart extremes, then the farthest from their line,
+	// then the farthest from the plane of those three
+	int i0 = extremes[0], i1 = extremes[1];
+	for (int axis = 1; axis < 3; axis++) {
+		if (length(makeVector3dFromPoints(points[extremes[2 * axis]], points[extremes[2 * axis + 1]])) > length(makeVector3dFromPoints(points[i0], points[i1]))) {
+			i0 = extremes[2 * axis];
+			i1 = extremes[2 * axis + 1];
+		}
+	}
+	if (length(makeVector3dFromPoints(points[i0], points[i1])) <= tolerance) {
+		vertices->push_back(points[i0]);
+		return;
+	}
+
+	struct vector3d line = makeVector3dFromPoints(points[i0], points[i1]);
+	int i2 = -1;
+	double farthest = 0;
+	for (int i = 0; i < n; i++) {
+		double distance = length(crossProduct3d(line, makeVector3dFromPoints(points[i0], points[i]))) / length(line);
+		if (distance > farthest) {
+			farthest = distance;
+			i2 = i;
+		}
+	}
+	if (farthest <= tolerance) {
+		vertices->push_back(points[i0]);
+		vertices->push_back(points[i1]);
+		return;
+	}
+
+	struct vector3d normal = crossProduct3d(line, makeVector3dFromPoints(points[i0], points[i2]));
+	double normalLength = length(normal);
+	normal = { normal.x / normalLength, normal.y / normalLength, normal.z / normalLength };
+	int i3 = -1;
+	farthest = 0;
+	for (int i = 0; i < n; i++) {
+		double distance = dotProduct3d(normal, makeVector3dFromPoints(points[i0], points[i]));
+		if (fabs(distance) > fabs(farthest)) {
+			farthest = distance;
+			i3 = i;
+		}
+	}
+
+	if (fabs(farthest) <= tolerance) {
+		/* Flat: the polygon is the 2D hull of the points in the plane's own coordinates, and
+		 * it is given a fan of faces on each side */
+		struct vector3d u = { line.x / length(line), line.y / length(line), line.z / length(line) };
+		struct vector3d v = crossProduct3d(normal, u);
+		std::vector<struct point> projected(n);
+		std::map<std::pair<double, double>, int> original;
+		for (int i = 0; i < n; i++) {
+			struct vector3d r = makeVector3dFromPoints(points[i0], points[i]);
+			projected[i] = { dotProduct3d(r, u), dotProduct3d(r, v) };
+			original[{ projected[i].x, projected[i].y }] = i;
+		}
+		std::vector<struct point> chain = monotoneChainHull(projected);
+		std::vector<struct point> polygon = strictConvexPolygon(&chain);
+		for (int k = 0; k < polygon.size(); k++)
+			vertices->push_back(points[original[{ polygon[k].x, polygon[k].y }]]);
+		for (int k = 1; k + 1 < polygon.size(); k++) {
+			faces->push_back({ 0, k, k + 1 });
+			faces->push_back({ 0, k + 1, k });
+		}
+		flat = true;
+		return;
+	}
+
+	struct quickHull3d q;
+	q.points = &points;
+	q.tolerance = tolerance;
+	q.threads = threads;
+
+	// Wound so the first face looks away from the fourth point
+	int a = i0, b = i1, c = i2, d = i3;
+	if (farthest > 0)
+		std::swap(b, c);
+	int start[4] = { newFace(&q, a, b, c), newFace(&q, b, a, d), newFace(&q, c, b, d), newFace(&q, a, c, d) };
+	for (int f = 0; f < 4; f++) {
+		for (int e = q.faces[start[f]].edge, k = 0; k < 3; e = q.edges[e].next, k++) {
+			int from = q.edges[e].vertex, to = q.edges[q.edges[e].next].vertex;
+			for (int g = 0; g < 4; g++) {
+				for (int t = q.faces[start[g]].edge, m = 0; m < 3; t = q.edges[t].next, m++) {
+					if (q.edges[t].vertex == to && q.edges[q.edges[t].next].vertex == from)
+						q.edges[e].twin = t;
+				}
+			}
+		}
+	}
+
+	std::vector<int> rest;
+	for (int i = 0; i < n; i++) {
+		if (i != a && i != b && i != c && i != d)
+			rest.push_back(i);
+	}
+	std::vector<int> target;
+	assignPoints(&q, rest, std::vector<int>(start, start + 4), &target);
+	for (int i = 0; i < rest.size(); i++) {
+		if (target[i] >= 0)
+			q.faces[target[i]].conflicts.push_back(rest[i]);
+	}
+
+	std::vector<int> pending(start, start + 4);
+	while (pending.size() > 0) {
+		int f = pending.back();
+		pending.pop_back();
+		if (q.faces[f].alive && q.faces[f].conflicts.size() > 0)
+			addPoint(&q, f, &pending);
+	}
+
+	std::vector<int> index(n, -1);
+	for (int f = 0; f < q.faces.size(); f++) {
+		if (!q.faces[f].alive)
+			continue;
+		int corner[3];
+		for (int e = q.faces[f].edge, k = 0; k < 3; e = q.edges[e].next, k++) {
+			int p = q.edges[e].vertex;
+			if (index[p] < 0) {
+				index[p] = vertices->size();
+				vertices->push_back(points[p]);
+			}
+			corner[k] = index[p];
+		}
+		faces->push_back({ corner[0], corner[1], corner[2] });
+	}
+}
+
+/* Returns true if p is inside this hull or within rounding of its surface */
+bool ConvexHull3D::containsPoint(struct point3d p) {
+	std::vector<struct hullFace3d> *hullFaces = getFaces();
+	std::vector<struct point3d> &v = *vertices;
+
+	if (hullFaces->size() == 0) {
+		if (v.size() == 0)
+			return false;
+		struct vector3d offset = makeVector3dFromPoints(v[0], p);
+		if (v.size() == 1)
+			return length(offset) <= tolerance;
+		struct vector3d line = makeVector3dFromPoints(v[0], v[1]);
+		double along = dotProduct3d(offset, line) / dotProduct3d(line, line);
+		return length(crossProduct3d(line, offset)) / length(line) <= tolerance && along >= 0 && along <= 1;
+	}
+
+	for (int f = 0; f < hullFaces->size(); f++) {
+		struct hullFace3d face = (*hullFaces)[f];
+		struct vector3d normal = crossProduct3d(makeVector3dFromPoints(v[face.a], v[face.b]), makeVector3dFromPoints(v[face.a], v[face.c]));
+		double size = length(normal);
+		if (size > 0 && dotProduct3d(normal, makeVector3dFromPoints(v[face.a], p)) > tolerance * size)
+			return false;
+	}
+	if (!flat)
+		return true;
+
+	/* The two fans only hold p to the plane, so a flat hull also needs p inside each edge. The
+	 * polygon runs counter-clockwise around the first face's normal, so inwards from an edge is
+	 * the normal crossed with the edge. */
+	struct hullFace3d face = (*hullFaces)[0];
+	struct vector3d normal = crossProduct3d(makeVector3dFromPoints(v[face.a], v[face.b]), makeVector3dFromPoints(v[face.a], v[face.c]));
+	for (int k = 0; k < v.size(); k++) {
+		struct point3d next = v[(k + 1) % v.size()];
+		struct vector3d inwards = crossProduct3d(normal, makeVector3dFromPoints(v[k], next));
+		double size = length(inwards);
+		if (size > 0 && dotProduct3d(inwards, makeVector3dFromPoints(v[k], p)) < -tolerance * size)
+			return false;
+	}
+	return true;
+}
+
+struct point3d ConvexHull3D::support(struct vector3d d) {
+	std::vector<struct point3d> *points = getVertices();
+	int best = 0;
+	double bestDistance = -DBL_MAX;
+
+	for (int i = 0; i < points->size(); i++) {
+		double distance = dotProduct3d(toVector((*points)[i]), d);
+		if (distance > bestDistance) {
+			best = i;
+			bestDistance = distance;
+		}
+	}
+
+	return (*points)[best];
+}
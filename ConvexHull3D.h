@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include "DataTypes.h"
+
+/* Convex hull of a 3D point cloud by QuickHull, with the same lazy getHull-style API as
+ * ConvexHull.
+ * The hull is kept as a half-edge mesh of triangles while it grows. Every point still outside
+ * sits on the conflict list of one face it can see; the farthest point of a face is added by
+ * walking out from that face over everything it can see, which leaves the horizon as a loop of
+ * edges, and fanning new faces from the horizon to the point. The points on the conflict lists
+ * of the faces removed are handed to the new ones. Faces and half-edges come from pools with
+ * free lists, so the faces removed are reused along with their conflict lists' memory.
+ * With more than one thread, sorting points onto conflict lists, which is where large clouds
+ * spend their time, is split between the threads.
+ * Coplanar faces aren't merged, so a point lying on a flat side or an edge of the hull can
+ * still end up as a vertex, within the same rounding tolerance the plane tests use.
+ * Clouds with no volume give a flat hull: a polygon gets a fan of faces on each side, and a
+ * segment or a single point gets no faces at all. containsPoint checks a polygon's edges as well
+ * as its faces, since the two fans only bound the plane.
+ */
+
+struct hullFace3d {
+	int a, b, c;	// indices into getVertices(), counter-clockwise seen from outside
+};
+
+class ConvexHull3D
+{
+private:
+	std::vector<struct point3d> pointList;
+	std::vector<struct point3d> *vertices;
+	std::vector<struct hullFace3d> *faces;
+	double tolerance;
+	bool flat;		// the vertices are a polygon in order, and the faces two fans over it
+	int threads;
+
+	void build();
+public:
+	/* threads is the most threads to build with, 0 for one per core */
+	ConvexHull3D(std::vector<struct point3d> points, int threads = 1);
+	~ConvexHull3D();
+
+	std::vector<struct point3d> *getVertices();
+	std::vector<struct hullFace3d> *getFaces();
+	bool containsPoint(struct point3d p);
+	struct point3d support(struct vector3d d);
+};
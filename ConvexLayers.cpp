@@ -0,0 +1,100 @@
+#include "ConvexLayers.h"
+#include "ConvexHull.h"
+#include <chrono>
+#include <algorithm>
+
+static double orientation(struct point o, struct point a, struct point b) {
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool samePoint(struct point a, struct point b) {
+	return a.x == b.x && a.y == b.y;
+}
+
+/* Andrew's monotone chain over the points left in order, except that collinear points are kept
+ * rather than popped, so every point on the boundary is found, not just the corners. Only one
+ * of each run of equal points goes in, since a repeat would stop the ones before it from ever
+ * being popped. Returns positions in order. */
+static void boundaryChain(const std::vector<struct point> &points, const std::vector<int> &order, std::vector<int> *chain) {
+	int n = order.size();
+	chain->resize(2 * n + 1);
+	std::vector<int> &c = *chain;
+	int k = 0;
+	for (int i = 0; i < n; i++) {
+		if (i > 0 && samePoint(points[order[i]], points[order[i - 1]]))
+			continue;
+		while (k >= 2 && orientation(points[order[c[k - 2]]], points[order[c[k - 1]]], points[order[i]]) < 0)
+			k--;
+		c[k++] = i;
+	}
+	for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+		if (samePoint(points[order[i]], points[order[i + 1]]))
+			continue;
+		while (k >= lower && orientation(points[order[c[k - 2]]], points[order[c[k - 1]]], points[order[i]]) < 0)
+			k--;
+		c[k++] = i;
+	}
+	chain->resize(k > 1 ? k - 1 : k);
+}
+
+std::vector<struct convexLayer> convexLayers(const std::vector<struct point> &points, std::vector<int> *depth, double *sortMilliseconds) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<int> order(points.size());
+	for (int i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&](int a, int b) {
+		return points[a].x < points[b].x || (points[a].x == points[b].x && points[a].y < points[b].y);
+	});
+	if (sortMilliseconds)
+		*sortMilliseconds = millisecondsSince(start);
+
+	if (depth)
+		depth->assign(points.size(), -1);
+
+	std::vector<struct convexLayer> layers;
+	std::vector<int> chain;
+	std::vector<bool> taken(points.size(), false);
+	while (order.size() > 0) {
+		start = std::chrono::steady_clock::now();
+		struct convexLayer layer;
+		boundaryChain(points, order, &chain);
+
+		// Every copy of a point on the boundary goes with it; the copies are next to it in the index
+		std::vector<struct point> boundary;
+		for (int i = 0; i < chain.size(); i++) {
+			int first = chain[i];
+			while (first > 0 && samePoint(points[order[first - 1]], points[order[chain[i]]]))
+				first--;
+			boundary.push_back(points[order[first]]);
+			for (int j = first; j < order.size() && samePoint(points[order[j]], points[order[first]]); j++) {
+				int p = order[j];
+				if (!taken[p]) {
+					taken[p] = true;
+					layer.members.push_back(p);
+				}
+			}
+		}
+		layer.hull = monotoneChainHull(boundary);
+
+		// Squeezes the points taken out of the index, which stays sorted
+		int kept = 0;
+		for (int i = 0; i < order.size(); i++) {
+			if (!taken[order[i]])
+				order[kept++] = order[i];
+		}
+		order.resize(kept);
+
+		if (depth) {
+			for (int i = 0; i < layer.members.size(); i++)
+				(*depth)[layer.members[i]] = layers.size();
+		}
+		layer.milliseconds = millisecondsSince(start);
+		layers.push_back(layer);
+	}
+
+	return layers;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+#include "DataTypes.h"
+
+/* Convex layers (onion peeling): the hull of the points, then the hull of what is left once
+ * every point on it is removed, and so on until no points are left. The layer a point is on is
+ * its convex depth, used to score outliers.
+ * Rather than building a new ConvexHull per layer, which sorts everything left each time, the
+ * points are sorted by x then y once into an index shared by every layer. Each layer is a
+ * monotone chain over the index, and the points it takes are then squeezed out of the index in
+ * the same pass, keeping it sorted. A layer costs O(m) for the m points left, and n points in
+ * L layers O(n log n + n * L).
+ */
+
+struct convexLayer {
+	std::vector<struct point> hull;	// counter-clockwise from the bottommost vertex like getHull, without repeated or collinear vertices
+	std::vector<int> members;		// indices of every input point removed with this layer, including ones on its edges
+	double milliseconds;			// time taken to peel this layer
+};
+
+/* depth, if given, gets the layer of each point, 0 for the outermost. sortMilliseconds, if
+ * given, gets the time taken by the one sort that every layer shares. */
+std::vector<struct convexLayer> convexLayers(const std::vector<struct point> &points, std::vector<int> *depth = NULL, double *sortMilliseconds = NULL);
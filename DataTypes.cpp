@@ -1,5 +1,7 @@
 #include "DataTypes.h"
+#include "HullProfiler.h"
 #include <math.h>
+#include <algorithm>
 
 struct vector makeVectorFromPoints(struct point start, struct point end) {
 	return { end.x - start.x, end.y - start.y };
@@ -15,6 +17,18 @@ struct vector normalize(struct vector v) {
 	return { v.x / mag, v.y / mag };
 }
 
+struct vector3d makeVector3dFromPoints(struct point3d start, struct point3d end) {
+	return { end.x - start.x, end.y - start.y, end.z - start.z };
+}
+
+double dotProduct3d(struct vector3d v1, struct vector3d v2) {
+	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
+
+struct vector3d crossProduct3d(struct vector3d v1, struct vector3d v2) {
+	return { v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x };
+}
+
 /* Returns the index of the point in pointList which is farthest from the edge between p1 and p2,
 * on the left side of the edge.
 * If two points are equidistant from the edge, chooses the one which is perpendicular to the further point along the edge
@@ -23,6 +37,8 @@ struct vector normalize(struct vector v) {
 * Based on the implementation on page 68 of Real-Time Collision Detection
 */
 int getPointFarthestFromEdge(struct point p1, struct point p2, std::vector<struct point> *pointList){
+	HULL_PROFILE_COUNT(FARTHEST_SCANS, 1);
+	HULL_PROFILE_COUNT(POINTS_VISITED, pointList->size());
 	// The vector from p1 to p2
 	struct vector v = makeVectorFromPoints(p1, p2);
 	// The vector perpendicular to v
@@ -65,4 +81,66 @@ void printPoints(FILE *f, std::vector<struct point> *v, const char *firstLine) {
 	}
 
 	fprintf(f, "\n");
-}
\ No newline at end of file
+}
+static double turn(struct point o, struct point a, struct point b) {
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+/* Returns the vertices of hull (as returned by getHull) counter-clockwise, without repeated or
+ * collinear vertices, which is the form the rotating calipers and clipping code expect.
+ * A hull with no area comes back as its one or two extreme points.
+ */
+std::vector<struct point> strictConvexPolygon(std::vector<struct point> *hull) {
+	std::vector<struct point> result;
+
+	for (int i = 0; i < hull->size(); i++) {
+		struct point p = (*hull)[i];
+		if (result.size() > 0 && result.back().x == p.x && result.back().y == p.y)
+			continue;
+		while (result.size() >= 2 && turn(result[result.size() - 2], result.back(), p) == 0)
+			result.pop_back();
+		result.push_back(p);
+	}
+
+	// The same again across the point where the list wraps around
+	while (result.size() >= 2 && result.back().x == result[0].x && result.back().y == result[0].y)
+		result.pop_back();
+	while (result.size() >= 3 && turn(result[result.size() - 2], result.back(), result[0]) == 0)
+		result.pop_back();
+	while (result.size() >= 3 && turn(result.back(), result[0], result[1]) == 0)
+		result.erase(result.begin());
+
+	double area = 0;
+	for (int i = 0; i < result.size(); i++) {
+		struct point a = result[i], b = result[(i + 1) % result.size()];
+		area += a.x * b.y - a.y * b.x;
+	}
+
+	if (area < 0) {
+		for (int i = 0, j = result.size() - 1; i < j; i++, j--)
+			std::swap(result[i], result[j]);
+	}
+	else if (area == 0 && result.size() > 2) {
+		// Collinear: keep the two ends, which are the points farthest apart
+		int first = 0, last = 0;
+		for (int i = 1; i < result.size(); i++) {
+			if (result[i].x < result[first].x || (result[i].x == result[first].x && result[i].y < result[first].y))
+				first = i;
+			if (result[i].x > result[last].x || (result[i].x == result[last].x && result[i].y > result[last].y))
+				last = i;
+		}
+		result = { result[first], result[last] };
+	}
+
+	return result;
+}
+
+/* Rotates a counter-clockwise hull to start at its bottommost point, like getHull */
+void startAtBottom(std::vector<struct point> *hull) {
+	int start = 0;
+	for (int i = 1; i < hull->size(); i++) {
+		if ((*hull)[i].y < (*hull)[start].y || ((*hull)[i].y == (*hull)[start].y && (*hull)[i].x < (*hull)[start].x))
+			start = i;
+	}
+	std::rotate(hull->begin(), hull->begin() + start, hull->end());
+}
@@ -19,4 +19,22 @@ struct point {
 };
 
 int getPointFarthestFromEdge(struct point p1, struct point p2, std::vector<struct point> *pointList);
-void printPoints(FILE *f, std::vector<struct point> *v, const char *firstLine);
\ No newline at end of file
+std::vector<struct point> strictConvexPolygon(std::vector<struct point> *hull);
+void startAtBottom(std::vector<struct point> *hull);
+void printPoints(FILE *f, std::vector<struct point> *v, const char *firstLine);
+
+struct point3d {
+	double x;
+	double y;
+	double z;
+};
+
+struct vector3d {
+	double x;
+	double y;
+	double z;
+};
+
+struct vector3d makeVector3dFromPoints(struct point3d p1, struct point3d p2);
+double dotProduct3d(struct vector3d v1, struct vector3d v2);
+struct vector3d crossProduct3d(struct vector3d v1, struct vector3d v2);
\ No newline at end of file
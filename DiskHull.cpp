@@ -0,0 +1,184 @@
+#include "DiskHull.h"
+#include <math.h>
+#include <algorithm>
+
+#define TWO_PI 6.283185307179586
+
+// One piece of an envelope: disk is on top from start until the next piece's start
+struct envelopePiece {
+	int disk;
+	double start;
+};
+
+static double supportValue(struct disk d, double t) {
+	return d.center.x * cos(t) + d.center.y * sin(t) + d.radius;
+}
+
+static double normalizeAngle(double t) {
+	t = fmod(t, TWO_PI);
+	return t < 0 ? t + TWO_PI : t;
+}
+
+static void appendPiece(std::vector<struct envelopePiece> *envelope, int disk, double start) {
+	if (envelope->size() > 0 && envelope->back().disk == disk)
+		return;
+	envelope->push_back({ disk, start });
+}
+
+/* Merges two envelopes over the same full turn. Between consecutive breakpoints of either one
+ * the two disks on top are fixed, and the difference of their support functions,
+ * |ca - cb| cos(t - phi) + ra - rb, changes sign at most at the two angles where the cosine
+ * equals (rb - ra) / |ca - cb|. */
+static void mergeEnvelopes(const std::vector<struct disk> &disks, const std::vector<struct envelopePiece> &a,
+	const std::vector<struct envelopePiece> &b, std::vector<struct envelopePiece> *merged) {
+	merged->clear();
+	int ia = 0, ib = 0;
+	double t = 0;
+
+	while (t < TWO_PI) {
+		double nextA = ia + 1 < a.size() ? a[ia + 1].start : TWO_PI;
+		double nextB = ib + 1 < b.size() ? b[ib + 1].start : TWO_PI;
+		double end = std::min(nextA, nextB);
+		struct disk da = disks[a[ia].disk], db = disks[b[ib].disk];
+
+		double cuts[4] = { t, end, end, end };
+		int cutCount = 1;
+		double dx = da.center.x - db.center.x, dy = da.center.y - db.center.y;
+		double distance = hypot(dx, dy);
+		// With no sign change one disk contains the other, and the bigger one is on top throughout
+		bool crossing = distance > 0 && fabs(db.radius - da.radius) < distance;
+		if (crossing) {
+			double phi = atan2(dy, dx), spread = acos((db.radius - da.radius) / distance);
+			double roots[2] = { normalizeAngle(phi - spread), normalizeAngle(phi + spread) };
+			if (roots[0] > roots[1])
+				std::swap(roots[0], roots[1]);
+			for (int r = 0; r < 2; r++) {
+				if (roots[r] > t && roots[r] < end)
+					cuts[cutCount++] = roots[r];
+			}
+		}
+		cuts[cutCount] = end;
+
+		for (int c = 0; c < cutCount; c++) {
+			if (cuts[c + 1] <= cuts[c])
+				continue;
+			double middle = (cuts[c] + cuts[c + 1]) / 2;
+			bool first = crossing ? supportValue(da, middle) >= supportValue(db, middle) : da.radius >= db.radius;
+			appendPiece(merged, first ? a[ia].disk : b[ib].disk, cuts[c]);
+		}
+
+		t = end;
+		if (nextA == end)
+			ia++;
+		if (nextB == end)
+			ib++;
+	}
+}
+
+static void envelope(const std::vector<struct disk> &disks, int begin, int end, std::vector<struct envelopePiece> *result) {
+	if (end - begin == 1) {
+		result->assign(1, { begin, 0 });
+		return;
+	}
+
+	int middle = (begin + end) / 2;
+	std::vector<struct envelopePiece> left, right;
+	envelope(disks, begin, middle, &left);
+	envelope(disks, middle, end, &right);
+	mergeEnvelopes(disks, left, right, result);
+}
+
+DiskHull::DiskHull(std::vector<struct disk> disks) {
+	this->disks = disks;
+	this->arcs = NULL;
+}
+
+DiskHull::~DiskHull() {
+	delete arcs;
+}
+
+std::vector<struct diskArc> *DiskHull::getArcs() {
+	if (arcs)
+		return arcs;
+
+	arcs = new std::vector<struct diskArc>();
+	if (disks.size() == 0)
+		return arcs;
+
+	std::vector<struct envelopePiece> pieces;
+	envelope(disks, 0, disks.size(), &pieces);
+	for (int i = 0; i < pieces.size(); i++)
+		arcs->push_back({ pieces[i].disk, pieces[i].start, i + 1 < pieces.size() ? pieces[i + 1].start : TWO_PI });
+
+	// The same disk on top either side of angle 0 is one arc across it
+	if (arcs->size() > 1 && arcs->front().disk == arcs->back().disk) {
+		arcs->back().endAngle = TWO_PI + (*arcs)[0].endAngle;
+		arcs->erase(arcs->begin());
+	}
+	return arcs;
+}
+
+static struct point onCircle(struct disk d, double t) {
+	return { d.center.x + d.radius * cos(t), d.center.y + d.radius * sin(t) };
+}
+
+std::vector<struct tangentSegment> DiskHull::getTangents() {
+	std::vector<struct diskArc> &a = *getArcs();
+	std::vector<struct tangentSegment> tangents;
+	for (int i = 0; i < a.size(); i++) {
+		const struct diskArc &next = a[(i + 1) % a.size()];
+		tangents.push_back({ onCircle(disks[a[i].disk], a[i].endAngle), onCircle(disks[next.disk], next.startAngle) });
+	}
+	return tangents;
+}
+
+struct point DiskHull::support(struct vector d) {
+	std::vector<struct diskArc> &a = *getArcs();
+	double t = normalizeAngle(atan2(d.y, d.x));
+
+	// The last arc whose start is at or before t, or the last arc, which wraps past 2 * pi
+	int low = 0, high = a.size() - 1;
+	if (t < a[0].startAngle)
+		low = high;
+	while (low < high) {
+		int middle = (low + high + 1) / 2;
+		if (a[middle].startAngle <= t)
+			low = middle;
+		else
+			high = middle - 1;
+	}
+
+	struct disk best = disks[a[low].disk];
+	double length = hypot(d.x, d.y);
+	if (length == 0)
+		return best.center;
+	return { best.center.x + best.radius * d.x / length, best.center.y + best.radius * d.y / length };
+}
+
+/* p is inside when it is no farther out than the hull in every direction. Along one arc that is
+ * |c - p| cos(t - theta) + r for the angle theta of p - c, which is smallest at theta if the arc
+ * reaches that far and otherwise at one of its ends. */
+bool DiskHull::containsPoint(struct point p) {
+	std::vector<struct diskArc> &a = *getArcs();
+	if (a.size() == 0)
+		return false;
+
+	double scale = fabs(p.x) + fabs(p.y);
+	for (int i = 0; i < disks.size(); i++)
+		scale = std::max(scale, fabs(disks[i].center.x) + fabs(disks[i].center.y) + disks[i].radius);
+	double tolerance = 1e-12 * scale;
+
+	for (int i = 0; i < a.size(); i++) {
+		struct disk d = disks[a[i].disk];
+		double dx = d.center.x - p.x, dy = d.center.y - p.y;
+		double lowest = std::min(dx * cos(a[i].startAngle) + dy * sin(a[i].startAngle), dx * cos(a[i].endAngle) + dy * sin(a[i].endAngle));
+		double theta = normalizeAngle(atan2(-dy, -dx));
+		if (theta < a[i].startAngle)
+			theta += TWO_PI;
+		if (theta <= a[i].endAngle)
+			lowest = -hypot(dx, dy);
+		if (lowest + d.radius < -tolerance)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include "DataTypes.h"
+
+/* Convex hull of disks, such as the editor's points with their radii, so rounded bodies can be
+ * hit-tested and collided exactly rather than through their centers or a tessellation.
+ * The boundary alternates between arcs of the disks and the outer tangents joining them.
+ * Each arc is where one disk is the farthest along the outward normal, so the boundary is the
+ * upper envelope of the disks' support functions x cos(t) + y sin(t) + r over the angle t.
+ * Envelopes of halves are built recursively and merged in one sweep over their breakpoints:
+ * between two breakpoints the difference of two support functions is a shifted cosine, which
+ * changes sign at most twice, at angles found directly. O(n log n) overall.
+ */
+
+struct disk {
+	struct point center;
+	double radius;
+};
+
+/* The part of a disk's circle on the hull, counter-clockwise from startAngle to endAngle, which
+ * are the directions of the outward normal. The tangent to the next arc leaves at endAngle. */
+struct diskArc {
+	int disk;			// index into the disks the hull was built from
+	double startAngle;	// in [0, 2 * pi), except that the last arc ends at the first one's start + 2 * pi
+	double endAngle;
+};
+
+struct tangentSegment {
+	struct point start;
+	struct point end;
+};
+
+class DiskHull
+{
+private:
+	std::vector<struct disk> disks;
+	std::vector<struct diskArc> *arcs;
+
+public:
+	DiskHull(std::vector<struct disk> disks);
+	~DiskHull();
+
+	/* Counter-clockwise in order of startAngle */
+	std::vector<struct diskArc> *getArcs();
+	/* The tangent from the end of each arc to the start of the next one, possibly of no length */
+	std::vector<struct tangentSegment> getTangents();
+
+	/* The point of the hull farthest along d, in O(log h) */
+	struct point support(struct vector d);
+	/* True if p is inside the hull or on its boundary */
+	bool containsPoint(struct point p);
+};
@@ -0,0 +1,140 @@
+#include "EPA.h"
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+
+static double cross(struct point a, struct point b) {
+	return a.x * b.y - a.y * b.x;
+}
+
+static double dot(struct point a, struct vector d) {
+	return a.x * d.x + a.y * d.y;
+}
+
+/* Unit outward normal of the counter-clockwise edge a-b, or {0, 0} if a == b */
+static struct vector outwardNormal(struct point a, struct point b) {
+	struct vector n = { b.y - a.y, a.x - b.x };
+	double length = sqrt(n.x * n.x + n.y * n.y);
+	if (length == 0)
+		return { 0, 0 };
+
+	n.x /= length;
+	n.y /= length;
+	return n;
+}
+
+static bool samePoint(struct point a, struct point b) {
+	return a.x == b.x && a.y == b.y;
+}
+
+/* Turns whatever GJK ended on into a counter-clockwise triangle around the origin.
+ * GJK stops early with a vertex or an edge when the origin is on it, so those are
+ * grown along directions away from the feature. */
+static bool initialPolygon(ConvexHull *a, ConvexHull *b, const struct gjkSimplex *simplex, std::vector<struct gjkVertex> *polygon) {
+	polygon->assign(simplex->v, simplex->v + simplex->count);
+
+	if (polygon->size() == 1) {
+		struct vector directions[] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+		for (int i = 0; i < 4 && polygon->size() < 2; i++) {
+			struct gjkVertex v = gjkSupport(a, b, directions[i]);
+			if (!samePoint(v.p, (*polygon)[0].p))
+				polygon->push_back(v);
+		}
+	}
+
+	if (polygon->size() == 2) {
+		struct point p0 = (*polygon)[0].p, p1 = (*polygon)[1].p;
+		struct vector n = { p0.y - p1.y, p1.x - p0.x };
+		struct gjkVertex v = gjkSupport(a, b, n);
+		if (fabs(cross({ p1.x - p0.x, p1.y - p0.y }, { v.p.x - p0.x, v.p.y - p0.y })) == 0)
+			v = gjkSupport(a, b, { -n.x, -n.y });
+		polygon->push_back(v);
+	}
+
+	if (polygon->size() < 3)
+		return false;
+
+	struct point p0 = (*polygon)[0].p, p1 = (*polygon)[1].p, p2 = (*polygon)[2].p;
+	double area = cross({ p1.x - p0.x, p1.y - p0.y }, { p2.x - p0.x, p2.y - p0.y });
+	if (area == 0)
+		return false;
+	if (area < 0)
+		std::swap((*polygon)[1], (*polygon)[2]);
+	return true;
+}
+
+bool epaPenetration(ConvexHull *a, ConvexHull *b, const struct gjkSimplex *simplex, struct epaResult *result) {
+	result->depth = 0;
+	result->normal = { 0, 0 };
+	result->iterations = 0;
+
+	std::vector<struct gjkVertex> polygon;
+	if (!initialPolygon(a, b, simplex, &polygon)) {
+		result->contactA = simplex->v[0].a;
+		result->contactB = simplex->v[0].b;
+		return false;
+	}
+
+	int closest = 0;
+	double distance = DBL_MAX;
+	struct vector normal = { 0, 0 };
+
+	while (result->iterations < EPA_MAX_ITERATIONS) {
+		result->iterations++;
+
+		// The edge closest to the origin
+		distance = DBL_MAX;
+		for (int i = 0; i < polygon.size(); i++) {
+			int j = (i + 1) % polygon.size();
+			struct vector n = outwardNormal(polygon[i].p, polygon[j].p);
+			double d = dot(polygon[i].p, n);
+			if ((n.x != 0 || n.y != 0) && d < distance) {
+				distance = d;
+				normal = n;
+				closest = i;
+			}
+		}
+
+		struct gjkVertex w = gjkSupport(a, b, normal);
+		if (dot(w.p, normal) - distance <= 1e-9 * (1 + distance))
+			break;
+
+		bool repeated = false;
+		for (int i = 0; i < polygon.size(); i++) {
+			if (samePoint(polygon[i].p, w.p))
+				repeated = true;
+		}
+		if (repeated)
+			break;
+
+		polygon.insert(polygon.begin() + closest + 1, w);
+	}
+
+	// The origin projects onto the closest edge at normal * distance; the same weights give the contacts
+	struct gjkVertex v0 = polygon[closest], v1 = polygon[(closest + 1) % polygon.size()];
+	struct point edge = { v1.p.x - v0.p.x, v1.p.y - v0.p.y };
+	double length = edge.x * edge.x + edge.y * edge.y;
+	double t = length > 0 ? -(v0.p.x * edge.x + v0.p.y * edge.y) / length : 0;
+	t = t < 0 ? 0 : (t > 1 ? 1 : t);
+
+	result->depth = distance;
+	result->normal = normal;
+	result->contactA = { v0.a.x + (v1.a.x - v0.a.x) * t, v0.a.y + (v1.a.y - v0.a.y) * t };
+	result->contactB = { v0.b.x + (v1.b.x - v0.b.x) * t, v0.b.y + (v1.b.y - v0.b.y) * t };
+	return distance > 0;
+}
+
+bool hullPenetration(ConvexHull *a, ConvexHull *b, struct epaResult *result) {
+	struct gjkSimplex simplex;
+	struct gjkResult gjk;
+	if (!gjkQuery(a, b, &simplex, &gjk)) {
+		result->depth = 0;
+		result->normal = { 0, 0 };
+		result->contactA = gjk.closestA;
+		result->contactB = gjk.closestB;
+		result->iterations = 0;
+		return false;
+	}
+
+	return epaPenetration(a, b, &simplex, result);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "DataTypes.h"
+#include "ConvexHull.h"
+#include "GJK.h"
+
+/* Expanding Polytope Algorithm: penetration depth and contact normal of two overlapping hulls.
+ * It grows the simplex GJK stopped on into a polygon inside the Minkowski difference A - B,
+ * one support vertex at a time, always pushing out the edge closest to the origin. When an
+ * edge can't be pushed out any further it is on the boundary of A - B, and its distance from
+ * the origin is the penetration depth. Only the support functions are used, never the
+ * |A|*|B| point cloud.
+ */
+
+#define EPA_MAX_ITERATIONS 64
+
+struct epaResult {
+	double depth;
+	struct vector normal;		// unit length, from A towards B: moving B by normal * depth separates them
+	struct point contactA;		// deepest point of each hull inside the other
+	struct point contactB;
+	int iterations;
+};
+
+/* Continues from a simplex left by gjkQuery for intersecting hulls. Returns false if the
+ * hulls only touch or have no area, in which case depth is 0. */
+bool epaPenetration(ConvexHull *a, ConvexHull *b, const struct gjkSimplex *simplex, struct epaResult *result);
+
+/* Runs GJK and then EPA. Returns false if the hulls don't overlap. */
+bool hullPenetration(ConvexHull *a, ConvexHull *b, struct epaResult *result);
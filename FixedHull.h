@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include "DataTypes.h"
+
+/* Convex hull of exactly N points, for the tiny fixed-size shapes such as the six-point hulls of
+ * the GJK scenario, where ConvexHull spends more on its vectors than on the hull itself.
+ * Everything is held in std::arrays sized by N, so there is no heap at all, and every loop has
+ * a trip count fixed by N, so the compiler can unroll them. The points are sorted by counting
+ * ranks, which needs no branches at all; the monotone chain over them is the only part that
+ * depends on the data.
+ * Every member is constexpr, so a hull can be built at compile time:
+ *
+ *	constexpr FixedHull<4> square({ { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } } });
+ *	static_assert(square.size() == 4, "");
+ *
+ * The hull is counter-clockwise from its bottommost vertex like getHull, without repeated or
+ * collinear vertices.
+ */
+template <int N>
+class FixedHull
+{
+private:
+	std::array<struct point, N> vertices;
+	int count;
+
+	static constexpr double orientation(struct point o, struct point a, struct point b) {
+		return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+	}
+
+public:
+	constexpr FixedHull(const std::array<struct point, N> &points) : vertices{}, count(0) {
+		/* Sorted by rank: each point's place is the number of points before it, with ties going
+		 * to the earlier index. N squared comparisons, but for small N they are cheaper than the
+		 * mispredicted branches of a comparison sort, since the counts are sums of flags. */
+		std::array<struct point, N> sorted{};
+		for (int i = 0; i < N; i++) {
+			int rank = 0;
+			for (int j = 0; j < N; j++) {
+				bool sameX = points[j].x == points[i].x;
+				rank += (points[j].x < points[i].x) | (sameX & (points[j].y < points[i].y)) | (sameX & (points[j].y == points[i].y) & (j < i));
+			}
+			sorted[rank] = points[i];
+		}
+
+		// Andrew's monotone chain; the last point pushed is the first one again
+		std::array<struct point, 2 * N + 1> chain{};
+		int k = 0;
+		for (int i = 0; i < N; i++) {
+			while (k >= 2 && orientation(chain[k - 2], chain[k - 1], sorted[i]) <= 0)
+				k--;
+			chain[k++] = sorted[i];
+		}
+		for (int i = N - 2, lower = k + 1; i >= 0; i--) {
+			while (k >= lower && orientation(chain[k - 2], chain[k - 1], sorted[i]) <= 0)
+				k--;
+			chain[k++] = sorted[i];
+		}
+		count = N > 1 ? k - 1 : N;
+
+		// All points equal: the chain is the one point twice
+		if (count == 2 && chain[0].x == chain[1].x && chain[0].y == chain[1].y)
+			count = 1;
+
+		int first = 0;
+		for (int i = 1; i < count; i++) {
+			if (chain[i].y < chain[first].y || (chain[i].y == chain[first].y && chain[i].x < chain[first].x))
+				first = i;
+		}
+		for (int i = 0; i < count; i++)
+			vertices[i] = chain[first + i < count ? first + i : first + i - count];
+	}
+
+	constexpr int size() const { return count; }
+	constexpr struct point operator[](int i) const { return vertices[i]; }
+
+	/* True if p is inside or on the boundary */
+	constexpr bool containsPoint(struct point p) const {
+		if (count < 3) {
+			for (int i = 0; i < count; i++) {
+				int j = (i + 1) % count;
+				if (orientation(vertices[i], vertices[j], p) != 0)
+					return false;
+				if (p.x < std::min(vertices[i].x, vertices[j].x) || p.x > std::max(vertices[i].x, vertices[j].x) ||
+					p.y < std::min(vertices[i].y, vertices[j].y) || p.y > std::max(vertices[i].y, vertices[j].y))
+					return false;
+			}
+			return count > 0;
+		}
+
+		for (int i = 0; i < count; i++) {
+			if (orientation(vertices[i], vertices[(i + 1) % count], p) < 0)
+				return false;
+		}
+		return true;
+	}
+
+	/* The vertex farthest along d */
+	constexpr struct point support(struct vector d) const {
+		int best = 0;
+		for (int i = 1; i < count; i++) {
+			if (vertices[i].x * d.x + vertices[i].y * d.y > vertices[best].x * d.x + vertices[best].y * d.y)
+				best = i;
+		}
+		return vertices[best];
+	}
+
+	std::vector<struct point> toVector() const {
+		return std::vector<struct point>(vertices.begin(), vertices.begin() + count);
+	}
+};
@@ -0,0 +1,203 @@
+#include "GJK.h"
+#include <math.h>
+
+static double cross(struct point a, struct point b) {
+	return a.x * b.y - a.y * b.x;
+}
+
+static double dot(struct point a, struct point b) {
+	return a.x * b.x + a.y * b.y;
+}
+
+static struct point subtract(struct point a, struct point b) {
+	return { a.x - b.x, a.y - b.y };
+}
+
+struct gjkVertex gjkSupport(ConvexHull *a, ConvexHull *b, struct vector d, struct vector offsetB) {
+	struct point pa = a->support(d);
+	struct point pb = b->support({ -d.x, -d.y });
+	pb.x += offsetB.x;
+	pb.y += offsetB.y;
+	return { subtract(pa, pb), pa, pb, d };
+}
+
+/* Closest point to the origin on the segment v[i]-v[j] of the simplex, written as weights */
+static double closestOnSegment(struct gjkSimplex *s, int i, int j, double *wi, double *wj) {
+	struct point a = s->v[i].p;
+	struct point ab = subtract(s->v[j].p, a);
+	double length = dot(ab, ab);
+	double t = length > 0 ? -dot(a, ab) / length : 0;
+
+	if (t < 0)
+		t = 0;
+	if (t > 1)
+		t = 1;
+
+	*wi = 1 - t;
+	*wj = t;
+	struct point closest = { a.x + ab.x * t, a.y + ab.y * t };
+	return dot(closest, closest);
+}
+
+/* Reduces the simplex to the smallest feature holding the point closest to the origin and
+ * returns that point. A triangle is only kept if it contains the origin. */
+static struct point closestOnSimplex(struct gjkSimplex *s) {
+	if (s->count == 2) {
+		double w0, w1;
+		closestOnSegment(s, 0, 1, &w0, &w1);
+		if (w1 == 0) {
+			s->count = 1;
+		}
+		else if (w0 == 0) {
+			s->v[0] = s->v[1];
+			s->count = 1;
+		}
+		else {
+			s->weight[0] = w0;
+			s->weight[1] = w1;
+		}
+	}
+	else if (s->count == 3) {
+		struct point a = s->v[0].p, b = s->v[1].p, c = s->v[2].p;
+		double area = cross(subtract(b, a), subtract(c, a));
+
+		if (area != 0) {
+			double wa = cross(b, c) / area;
+			double wb = cross(c, a) / area;
+			double wc = cross(a, b) / area;
+			if (wa >= 0 && wb >= 0 && wc >= 0) {
+				s->weight[0] = wa;
+				s->weight[1] = wb;
+				s->weight[2] = wc;
+				return { 0, 0 };
+			}
+		}
+
+		// The origin is outside, so the closest point is on one of the edges
+		int edges[3][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
+		int bestEdge = 0;
+		double best = -1, bestWi = 1, bestWj = 0;
+		for (int e = 0; e < 3; e++) {
+			double wi, wj;
+			double distance = closestOnSegment(s, edges[e][0], edges[e][1], &wi, &wj);
+			if (best < 0 || distance < best) {
+				best = distance;
+				bestEdge = e;
+				bestWi = wi;
+				bestWj = wj;
+			}
+		}
+
+		struct gjkVertex vi = s->v[edges[bestEdge][0]], vj = s->v[edges[bestEdge][1]];
+		if (bestWj == 0) {
+			s->v[0] = vi;
+			s->count = 1;
+		}
+		else if (bestWi == 0) {
+			s->v[0] = vj;
+			s->count = 1;
+		}
+		else {
+			s->v[0] = vi;
+			s->v[1] = vj;
+			s->weight[0] = bestWi;
+			s->weight[1] = bestWj;
+			s->count = 2;
+		}
+	}
+
+	if (s->count == 1)
+		s->weight[0] = 1;
+
+	struct point closest = { 0, 0 };
+	for (int i = 0; i < s->count; i++) {
+		closest.x += s->v[i].p.x * s->weight[i];
+		closest.y += s->v[i].p.y * s->weight[i];
+	}
+	return closest;
+}
+
+/* Replaces the simplex with the support points along the directions it was built from, dropping
+ * any that now coincide */
+static void resample(ConvexHull *a, ConvexHull *b, struct vector offsetB, struct gjkSimplex *simplex) {
+	int count = 0;
+	for (int i = 0; i < simplex->count; i++) {
+		struct gjkVertex v = gjkSupport(a, b, simplex->v[i].d, offsetB);
+		bool repeated = false;
+		for (int j = 0; j < count; j++) {
+			if (simplex->v[j].p.x == v.p.x && simplex->v[j].p.y == v.p.y)
+				repeated = true;
+		}
+		if (!repeated)
+			simplex->v[count++] = v;
+	}
+	simplex->count = count;
+}
+
+/* Runs GJK between a and b. The simplex it ends on is left in simplex.
+ * Returns true if the hulls intersect (touching counts). */
+bool gjkQuery(ConvexHull *a, ConvexHull *b, struct gjkSimplex *simplex, struct gjkResult *result, bool warmStart, struct vector offsetB) {
+	struct point closest;
+	if (warmStart && simplex->count > 0) {
+		resample(a, b, offsetB, simplex);
+		if (simplex->count == 1)
+			simplex->weight[0] = 1;
+		closest = closestOnSimplex(simplex);
+	}
+	else {
+		struct vector d = { 1, 0 };
+		simplex->v[0] = gjkSupport(a, b, d, offsetB);
+		simplex->weight[0] = 1;
+		simplex->count = 1;
+		closest = simplex->v[0].p;
+	}
+
+	double scale = dot(closest, closest) + 1;
+	result->intersecting = false;
+	result->iterations = 0;
+
+	while (result->iterations < GJK_MAX_ITERATIONS) {
+		result->iterations++;
+		double distanceSquared = dot(closest, closest);
+		if (simplex->count == 3 || distanceSquared <= 1e-20 * scale) {
+			result->intersecting = true;
+			break;
+		}
+
+		struct gjkVertex w = gjkSupport(a, b, { -closest.x, -closest.y }, offsetB);
+
+		// No support point gets meaningfully closer to the origin than the current one
+		if (distanceSquared - dot(closest, w.p) <= 1e-12 * distanceSquared)
+			break;
+
+		bool repeated = false;
+		for (int i = 0; i < simplex->count; i++) {
+			if (simplex->v[i].p.x == w.p.x && simplex->v[i].p.y == w.p.y)
+				repeated = true;
+		}
+		if (repeated)
+			break;
+
+		simplex->v[simplex->count++] = w;
+		closest = closestOnSimplex(simplex);
+	}
+
+	struct point closestA = { 0, 0 }, closestB = { 0, 0 };
+	for (int i = 0; i < simplex->count; i++) {
+		closestA.x += simplex->v[i].a.x * simplex->weight[i];
+		closestA.y += simplex->v[i].a.y * simplex->weight[i];
+		closestB.x += simplex->v[i].b.x * simplex->weight[i];
+		closestB.y += simplex->v[i].b.y * simplex->weight[i];
+	}
+
+	result->closestA = closestA;
+	result->closestB = closestB;
+	result->distance = result->intersecting ? 0 : sqrt(dot(closest, closest));
+	return result->intersecting;
+}
+
+bool gjkIntersect(ConvexHull *a, ConvexHull *b) {
+	struct gjkSimplex simplex;
+	struct gjkResult result;
+	return gjkQuery(a, b, &simplex, &result);
+}
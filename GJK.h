@@ -0,0 +1,44 @@
+#pragma once
+
+#include "DataTypes.h"
+#include "ConvexHull.h"
+
+/* GJK on the support functions of two hulls.
+ * Unlike minkowskiDifference + containsPoint it never builds the |A|*|B| point cloud: each
+ * iteration asks both hulls for one support vertex. Besides the yes/no answer it reports the
+ * distance and closest points of separated hulls, and leaves behind the simplex it stopped on
+ * (a triangle around the origin when the hulls overlap), which EPA continues from.
+ */
+
+#define GJK_MAX_ITERATIONS 64
+
+/* A vertex of the Minkowski difference A - B, along with the hull vertices it came from
+ * and the direction it was the support point for */
+struct gjkVertex {
+	struct point p;
+	struct point a;
+	struct point b;
+	struct vector d;
+};
+
+struct gjkSimplex {
+	struct gjkVertex v[3];
+	double weight[3];	// barycentric weights of the point closest to the origin
+	int count;
+};
+
+struct gjkResult {
+	bool intersecting;
+	double distance;		// 0 when intersecting
+	struct point closestA;	// closest points on each hull when separated
+	struct point closestB;
+	int iterations;
+};
+
+/* offsetB translates b without rebuilding it, for queries along a motion */
+struct gjkVertex gjkSupport(ConvexHull *a, ConvexHull *b, struct vector d, struct vector offsetB = { 0, 0 });
+/* With warmStart, the simplex from an earlier query of the same pair is re-sampled along the
+ * directions it was built from, which usually finishes in one or two iterations when the hulls
+ * have barely moved */
+bool gjkQuery(ConvexHull *a, ConvexHull *b, struct gjkSimplex *simplex, struct gjkResult *result, bool warmStart = false, struct vector offsetB = { 0, 0 });
+bool gjkIntersect(ConvexHull *a, ConvexHull *b);
@@ -0,0 +1,194 @@
+#include "GJK3D.h"
+#include <math.h>
+
+static struct vector3d toVector(struct point3d p) {
+	return { p.x, p.y, p.z };
+}
+
+static double dot(struct point3d a, struct point3d b) {
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+struct gjkVertex3d gjkSupport3d(ConvexHull3D *a, ConvexHull3D *b, struct vector3d d) {
+	struct point3d pa = a->support(d);
+	struct point3d pb = b->support({ -d.x, -d.y, -d.z });
+	return { { pa.x - pb.x, pa.y - pb.y, pa.z - pb.z }, pa, pb, d };
+}
+
+/* Barycentric weights of the point closest to the origin on the affine hull of the k points,
+ * found by solving the normal equations by Cramer's rule. Returns false if the points are too
+ * close to degenerate for that to mean anything. */
+static bool affineClosest(struct point3d *p, int k, double *weights) {
+	if (k == 1) {
+		weights[0] = 1;
+		return true;
+	}
+
+	struct vector3d e[3];
+	for (int i = 1; i < k; i++)
+		e[i - 1] = makeVector3dFromPoints(p[0], p[i]);
+
+	double g[3][3], r[3];
+	double scale = 1;
+	for (int i = 0; i < k - 1; i++) {
+		for (int j = 0; j < k - 1; j++)
+			g[i][j] = dotProduct3d(e[i], e[j]);
+		r[i] = -dotProduct3d(e[i], toVector(p[0]));
+		scale *= g[i][i];
+	}
+
+	double t[3];
+	if (k == 2) {
+		if (g[0][0] <= 0)
+			return false;
+		t[0] = r[0] / g[0][0];
+	}
+	else if (k == 3) {
+		double det = g[0][0] * g[1][1] - g[0][1] * g[1][0];
+		if (det <= 1e-14 * scale)
+			return false;
+		t[0] = (r[0] * g[1][1] - g[0][1] * r[1]) / det;
+		t[1] = (g[0][0] * r[1] - r[0] * g[1][0]) / det;
+	}
+	else {
+		double det = g[0][0] * (g[1][1] * g[2][2] - g[1][2] * g[2][1])
+			- g[0][1] * (g[1][0] * g[2][2] - g[1][2] * g[2][0])
+			+ g[0][2] * (g[1][0] * g[2][1] - g[1][1] * g[2][0]);
+		if (det <= 1e-14 * scale)
+			return false;
+		for (int c = 0; c < 3; c++) {
+			double m[3][3];
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 3; j++)
+					m[i][j] = j == c ? r[i] : g[i][j];
+			}
+			t[c] = (m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+				- m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+				+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0])) / det;
+		}
+	}
+
+	weights[0] = 1;
+	for (int i = 1; i < k; i++) {
+		weights[i] = t[i - 1];
+		weights[0] -= t[i - 1];
+	}
+	return true;
+}
+
+/* Reduces the simplex to the smallest feature holding the point closest to the origin and
+ * returns that point. The tetrahedron is only kept if it contains the origin. */
+static struct point3d closestOnSimplex(struct gjkSimplex3d *s) {
+	int bestMask = 1, bestCount = 1;
+	double best = -1, bestWeights[4] = { 1, 0, 0, 0 };
+
+	for (int mask = 1; mask < (1 << s->count); mask++) {
+		struct point3d p[4];
+		int k = 0;
+		for (int i = 0; i < s->count; i++) {
+			if (mask & (1 << i))
+				p[k++] = s->v[i].p;
+		}
+
+		double w[4];
+		if (!affineClosest(p, k, w))
+			continue;
+		bool inside = true;
+		for (int i = 0; i < k && k > 1; i++) {
+			if (w[i] <= 0)
+				inside = false;
+		}
+		if (!inside)
+			continue;
+
+		struct point3d closest = { 0, 0, 0 };
+		for (int i = 0; i < k; i++) {
+			closest.x += p[i].x * w[i];
+			closest.y += p[i].y * w[i];
+			closest.z += p[i].z * w[i];
+		}
+		double distance = dot(closest, closest);
+		if (best < 0 || distance < best || (distance == best && k < bestCount)) {
+			best = distance;
+			bestMask = mask;
+			bestCount = k;
+			for (int i = 0; i < k; i++)
+				bestWeights[i] = w[i];
+		}
+	}
+
+	struct gjkVertex3d kept[4];
+	int k = 0;
+	for (int i = 0; i < s->count; i++) {
+		if (bestMask & (1 << i))
+			kept[k++] = s->v[i];
+	}
+	struct point3d closest = { 0, 0, 0 };
+	for (int i = 0; i < k; i++) {
+		s->v[i] = kept[i];
+		s->weight[i] = bestWeights[i];
+		closest.x += kept[i].p.x * bestWeights[i];
+		closest.y += kept[i].p.y * bestWeights[i];
+		closest.z += kept[i].p.z * bestWeights[i];
+	}
+	s->count = k;
+	return closest;
+}
+
+bool gjkQuery3d(ConvexHull3D *a, ConvexHull3D *b, struct gjkSimplex3d *simplex, struct gjkResult3d *result) {
+	simplex->v[0] = gjkSupport3d(a, b, { 1, 0, 0 });
+	simplex->weight[0] = 1;
+	simplex->count = 1;
+	struct point3d closest = simplex->v[0].p;
+
+	double scale = dot(closest, closest) + 1;
+	result->intersecting = false;
+	result->iterations = 0;
+
+	while (result->iterations < GJK3D_MAX_ITERATIONS) {
+		result->iterations++;
+		double distanceSquared = dot(closest, closest);
+		if (simplex->count == 4 || distanceSquared <= 1e-20 * scale) {
+			result->intersecting = true;
+			break;
+		}
+
+		struct gjkVertex3d w = gjkSupport3d(a, b, { -closest.x, -closest.y, -closest.z });
+
+		// No support point gets meaningfully closer to the origin than the current one
+		if (distanceSquared - dot(closest, w.p) <= 1e-12 * distanceSquared)
+			break;
+
+		bool repeated = false;
+		for (int i = 0; i < simplex->count; i++) {
+			if (simplex->v[i].p.x == w.p.x && simplex->v[i].p.y == w.p.y && simplex->v[i].p.z == w.p.z)
+				repeated = true;
+		}
+		if (repeated)
+			break;
+
+		simplex->v[simplex->count++] = w;
+		closest = closestOnSimplex(simplex);
+	}
+
+	struct point3d closestA = { 0, 0, 0 }, closestB = { 0, 0, 0 };
+	for (int i = 0; i < simplex->count; i++) {
+		closestA.x += simplex->v[i].a.x * simplex->weight[i];
+		closestA.y += simplex->v[i].a.y * simplex->weight[i];
+		closestA.z += simplex->v[i].a.z * simplex->weight[i];
+		closestB.x += simplex->v[i].b.x * simplex->weight[i];
+		closestB.y += simplex->v[i].b.y * simplex->weight[i];
+		closestB.z += simplex->v[i].b.z * simplex->weight[i];
+	}
+
+	result->closestA = closestA;
+	result->closestB = closestB;
+	result->distance = result->intersecting ? 0 : sqrt(dot(closest, closest));
+	return result->intersecting;
+}
+
+bool gjkIntersect3d(ConvexHull3D *a, ConvexHull3D *b) {
+	struct gjkSimplex3d simplex;
+	struct gjkResult3d result;
+	return gjkQuery3d(a, b, &simplex, &result);
+}
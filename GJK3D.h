@@ -0,0 +1,39 @@
+#pragma once
+
+#include "DataTypes.h"
+#include "ConvexHull3D.h"
+
+/* GJK on the support functions of two 3D hulls, the same loop as gjkQuery with a simplex of up
+ * to four vertices. The point of the simplex closest to the origin is found by trying each of
+ * its vertices, edges and faces (and the whole tetrahedron) and keeping the closest one whose
+ * barycentric weights are all positive; the simplex is then cut down to that feature.
+ */
+
+#define GJK3D_MAX_ITERATIONS 64
+
+struct gjkVertex3d {
+	struct point3d p;
+	struct point3d a;
+	struct point3d b;
+	struct vector3d d;
+};
+
+struct gjkSimplex3d {
+	struct gjkVertex3d v[4];
+	double weight[4];		// barycentric weights of the point closest to the origin
+	int count;
+};
+
+struct gjkResult3d {
+	bool intersecting;
+	double distance;			// 0 when intersecting
+	struct point3d closestA;	// closest points on each hull when separated
+	struct point3d closestB;
+	int iterations;
+};
+
+struct gjkVertex3d gjkSupport3d(ConvexHull3D *a, ConvexHull3D *b, struct vector3d d);
+/* Returns true if the hulls intersect (touching counts). The simplex it ends on is left in
+ * simplex. */
+bool gjkQuery3d(ConvexHull3D *a, ConvexHull3D *b, struct gjkSimplex3d *simplex, struct gjkResult3d *result);
+bool gjkIntersect3d(ConvexHull3D *a, ConvexHull3D *b);
@@ -0,0 +1,45 @@
+#include "GJKCache.h"
+
+GJKCache::GJKCache() {
+	resetStats();
+}
+
+unsigned long long GJKCache::key(int idA, int idB) {
+	return ((unsigned long long)(unsigned int)idA << 32) | (unsigned int)idB;
+}
+
+bool GJKCache::query(int idA, int idB, ConvexHull *a, ConvexHull *b, struct gjkResult *result) {
+	auto found = entries.find(key(idA, idB));
+	bool hit = found != entries.end();
+
+	struct gjkSimplex *simplex;
+	if (hit) {
+		simplex = &found->second;
+		counts.hits++;
+	}
+	else {
+		simplex = &entries[key(idA, idB)];
+		simplex->count = 0;
+		counts.misses++;
+	}
+
+	bool intersecting = gjkQuery(a, b, simplex, result, hit);
+	counts.iterations += result->iterations;
+	return intersecting;
+}
+
+void GJKCache::forget(int idA, int idB) {
+	entries.erase(key(idA, idB));
+}
+
+void GJKCache::clear() {
+	entries.clear();
+}
+
+struct gjkCacheStats GJKCache::stats() {
+	return counts;
+}
+
+void GJKCache::resetStats() {
+	counts = { 0, 0, 0 };
+}
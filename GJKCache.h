@@ -0,0 +1,35 @@
+#pragma once
+
+#include <unordered_map>
+#include "GJK.h"
+
+/* Remembers the last GJK simplex of each pair of hulls and warm-starts the next query of the
+ * same pair from it. Pairs are identified by caller-chosen ids rather than ConvexHull
+ * pointers, since a dragged hull is rebuilt as a new object every frame. The order of the
+ * ids matters: (a, b) and (b, a) are different pairs. Not thread safe.
+ */
+
+struct gjkCacheStats {
+	long long hits;			// queries that started from a cached simplex
+	long long misses;		// queries that started from scratch
+	long long iterations;	// GJK iterations over all queries
+};
+
+class GJKCache
+{
+private:
+	std::unordered_map<unsigned long long, struct gjkSimplex> entries;
+	struct gjkCacheStats counts;
+
+	static unsigned long long key(int idA, int idB);
+public:
+	GJKCache();
+
+	bool query(int idA, int idB, ConvexHull *a, ConvexHull *b, struct gjkResult *result);
+	/* Drops a pair, e.g. once one of its hulls is replaced by an unrelated shape */
+	void forget(int idA, int idB);
+	void clear();
+
+	struct gjkCacheStats stats();
+	void resetStats();
+};
@@ -0,0 +1,178 @@
+#include "HalfPlane.h"
+#include <math.h>
+#include <thread>
+#include <algorithm>
+
+// Fewer problems than this per thread aren't worth starting a thread for
+#define MIN_PROBLEMS_PER_THREAD 16
+
+static double cross(struct vector a, struct vector b) {
+	return a.x * b.y - a.y * b.x;
+}
+
+/* How far q is to the left of h's line, in units of |d| */
+static double side(const struct halfPlane &h, struct point q) {
+	return cross(h.d, makeVectorFromPoints(h.p, q));
+}
+
+/* True if q is outside h by more than rounding in side could explain. The allowance is relative
+ * to the coordinates that go into the test, so it stays as tight for a small region as the
+ * numbers allow wherever the bounding square is. */
+static bool outside(const struct halfPlane &h, struct point q, double epsilon) {
+	double magnitude = fabs(h.p.x) + fabs(h.p.y) + fabs(q.x) + fabs(q.y);
+	return side(h, q) < -epsilon * magnitude * hypot(h.d.x, h.d.y);
+}
+
+static double distance(struct point a, struct point b) {
+	return hypot(b.x - a.x, b.y - a.y);
+}
+
+static struct point lineIntersection(const struct halfPlane &a, const struct halfPlane &b) {
+	double t = cross(makeVectorFromPoints(a.p, b.p), b.d) / cross(a.d, b.d);
+	return { a.p.x + a.d.x * t, a.p.y + a.d.y * t };
+}
+
+std::vector<struct point> halfPlaneIntersection(const std::vector<struct halfPlane> &planes, double bound) {
+	std::vector<struct halfPlane> sorted;
+	for (int i = 0; i < planes.size(); i++) {
+		if (planes[i].d.x != 0 || planes[i].d.y != 0)
+			sorted.push_back(planes[i]);
+	}
+	sorted.push_back({ { bound, -bound }, { 0, 1 } });
+	sorted.push_back({ { bound, bound }, { -1, 0 } });
+	sorted.push_back({ { -bound, bound }, { 0, -1 } });
+	sorted.push_back({ { -bound, -bound }, { 1, 0 } });
+
+	std::vector<double> angles(sorted.size());
+	std::vector<int> order(sorted.size());
+	for (int i = 0; i < sorted.size(); i++) {
+		angles[i] = atan2(sorted[i].d.y, sorted[i].d.x);
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return angles[a] < angles[b]; });
+
+	// Rounding allowance for the side tests, relative to the coordinates tested
+	double epsilon = 1e-12;
+
+	std::vector<struct halfPlane> deque(sorted.size());
+	int front = 0, back = 0;		// deque[front, back)
+	for (int k = 0; k < order.size(); k++) {
+		const struct halfPlane &h = sorted[order[k]];
+
+		while (back - front >= 2 && outside(h, lineIntersection(deque[back - 2], deque[back - 1]), epsilon))
+			back--;
+		while (back - front >= 2 && outside(h, lineIntersection(deque[front], deque[front + 1]), epsilon))
+			front++;
+
+		if (back - front > 0 && fabs(cross(h.d, deque[back - 1].d)) <= epsilon * hypot(h.d.x, h.d.y) * hypot(deque[back - 1].d.x, deque[back - 1].d.y)) {
+			if (h.d.x * deque[back - 1].d.x + h.d.y * deque[back - 1].d.y < 0) {
+				/* Facing opposite ways with nothing between them left to separate them: no overlap
+				 * unless the lines coincide, which leaves the region on that line */
+				if (outside(h, deque[back - 1].p, epsilon))
+					return std::vector<struct point>();
+			} else if (side(h, deque[back - 1].p) < 0) {
+				// Facing the same way: keep the tighter of the two
+				back--;
+			} else {
+				continue;
+			}
+		}
+		deque[back++] = h;
+	}
+
+	while (back - front >= 3 && outside(deque[front], lineIntersection(deque[back - 2], deque[back - 1]), epsilon))
+		back--;
+	while (back - front >= 3 && outside(deque[back - 1], lineIntersection(deque[front], deque[front + 1]), epsilon))
+		front++;
+	if (back - front < 3)
+		return std::vector<struct point>();
+
+	// Parallel neighbours only meet at infinity, which happens when the region is a line
+	std::vector<struct point> corners;
+	for (int i = front; i < back; i++) {
+		struct point corner = lineIntersection(deque[i], deque[i + 1 < back ? i + 1 : front]);
+		if (isfinite(corner.x) && isfinite(corner.y))
+			corners.push_back(corner);
+	}
+
+	/* The corners of the opposite chains can cross over when the region is empty. A region with
+	 * no area comes out of rounding as a sliver or a cluster of near copies of its corners, so
+	 * its area is only judged against its perimeter times the rounding allowance */
+	double area = 0, perimeter = 0, scale = 0;
+	for (int i = 0; i < corners.size(); i++) {
+		scale = std::max(scale, fabs(corners[i].x) + fabs(corners[i].y));
+		struct point next = corners[(i + 1) % corners.size()];
+		// About the first corner, since away from the origin the products would swamp a small area
+		area += cross(makeVectorFromPoints(corners[0], corners[i]), makeVectorFromPoints(corners[0], next)) / 2;
+		perimeter += distance(corners[i], next);
+	}
+	double tolerance = epsilon * scale;
+	if (area < -tolerance * perimeter)
+		return std::vector<struct point>();
+
+	std::vector<struct point> polygon;
+	if (corners.size() == 0)
+		return polygon;
+	if (perimeter <= tolerance) {
+		polygon.push_back(corners[0]);
+	} else if (area <= tolerance * perimeter) {
+		// A segment: its ends are the corner farthest from any corner and the one farthest from that
+		int a = 0, b = 0;
+		for (int i = 1; i < corners.size(); i++) {
+			if (distance(corners[i], corners[0]) > distance(corners[a], corners[0]))
+				a = i;
+		}
+		for (int i = 0; i < corners.size(); i++) {
+			if (distance(corners[i], corners[a]) > distance(corners[b], corners[a]))
+				b = i;
+		}
+		polygon.push_back(corners[a]);
+		polygon.push_back(corners[b]);
+		polygon = monotoneChainHull(polygon);
+	} else {
+		polygon = monotoneChainHull(corners);
+	}
+
+	/* Without area the sweep can't tell a sliver from nothing, so what is left has to be
+	 * checked against every half-plane, which is cheap with only one or two points */
+	if (polygon.size() < 3) {
+		for (int i = 0; i < polygon.size(); i++) {
+			for (int j = 0; j < sorted.size(); j++) {
+				if (outside(sorted[j], polygon[i], 1e-9))
+					return std::vector<struct point>();
+			}
+		}
+	}
+
+	return polygon;
+}
+
+ConvexHull *halfPlaneHull(const std::vector<struct halfPlane> &planes, double bound) {
+	std::vector<struct point> polygon = halfPlaneIntersection(planes, bound);
+	if (polygon.size() == 0)
+		return NULL;
+	// Built now, as intersection() does, since containsPoint doesn't build it
+	ConvexHull *result = new ConvexHull(polygon, HULL_MONOTONE_CHAIN);
+	result->getHull();
+	return result;
+}
+
+void halfPlaneIntersections(const std::vector<std::vector<struct halfPlane>> &problems, std::vector<std::vector<struct point>> *polygons, double bound, int threads) {
+	if (threads <= 0)
+		threads = std::max(1, (int)std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, (int)problems.size() / MIN_PROBLEMS_PER_THREAD));
+
+	polygons->resize(problems.size());
+	auto work = [&](int begin, int end) {
+		for (int i = begin; i < end; i++)
+			(*polygons)[i] = halfPlaneIntersection(problems[i], bound);
+	};
+
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; t++)
+		workers.push_back(std::thread(work, (int)((long long)problems.size() * t / threads), (int)((long long)problems.size() * (t + 1) / threads)));
+	work(0, problems.size() / threads);
+
+	for (int t = 0; t < workers.size(); t++)
+		workers[t].join();
+}
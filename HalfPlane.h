@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include "DataTypes.h"
+#include "ConvexHull.h"
+
+/* Intersection of half-planes by sorting them by angle and sweeping them through a deque, in
+ * O(n log n). The deque holds the half-planes whose lines still bound the region so far, in
+ * angle order; each new one first pops those at either end whose corner it cuts off. Of
+ * several half-planes facing the same way only the tightest is kept.
+ * Four half-planes bounding a square of side 2 * bound are always added, so a region that
+ * would be unbounded comes back clipped to the square rather than failing.
+ */
+
+#define HALF_PLANE_DEFAULT_BOUND 1e9
+
+/* The points to the left of the line through p in direction d, including the line */
+struct halfPlane {
+	struct point p;
+	struct vector d;
+};
+
+/* The vertices of the intersection counter-clockwise from the bottommost, like getHull, without
+ * repeated or collinear vertices. Empty if the half-planes have no point in common; a region with
+ * no area comes back as its one or two extreme points. */
+std::vector<struct point> halfPlaneIntersection(const std::vector<struct halfPlane> &planes, double bound = HALF_PLANE_DEFAULT_BOUND);
+
+/* The same as a hull, which containsPoint and the Minkowski operations accept, or NULL if
+ * the intersection is empty */
+ConvexHull *halfPlaneHull(const std::vector<struct halfPlane> &planes, double bound = HALF_PLANE_DEFAULT_BOUND);
+
+/* Solves independent problems spread over threads, 0 for one per core */
+void halfPlaneIntersections(const std::vector<std::vector<struct halfPlane>> &problems, std::vector<std::vector<struct point>> *polygons,
+	double bound = HALF_PLANE_DEFAULT_BOUND, int threads = 0);
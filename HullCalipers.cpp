@@ -0,0 +1,209 @@
+#include "HullCalipers.h"
+#include <math.h>
+#include <float.h>
+#include <thread>
+#include <algorithm>
+
+// The most pairs the walk starts with, before its first step
+#define START_PAIRS 4
+
+static struct vector edgeVector(std::vector<struct point> &polygon, int i) {
+	int n = polygon.size();
+	return makeVectorFromPoints(polygon[i % n], polygon[(i + 1) % n]);
+}
+
+static double cross(struct vector a, struct vector b) {
+	return a.x * b.y - a.y * b.x;
+}
+
+static double dot(struct point p, struct vector d) {
+	return p.x * d.x + p.y * d.y;
+}
+
+static double distance(struct point a, struct point b) {
+	return hypot(a.x - b.x, a.y - b.y);
+}
+
+/* Adds the pair unless it is one of the first checked pairs already in the list. Every step
+ * of the walk advances i or j, so the walk itself never repeats a pair; the only repeats come
+ * when the indices wrap past n at the end and land back on the pairs the walk started from,
+ * which are at most the first four. */
+static void addPair(std::vector<struct antipodalPair> *pairs, int n, int i, int j, int checked) {
+	i %= n;
+	j %= n;
+	if (i == j)
+		return;
+
+	struct antipodalPair pair = { std::min(i, j), std::max(i, j) };
+	for (int k = 0; k < checked && k < pairs->size(); k++) {
+		if ((*pairs)[k].i == pair.i && (*pairs)[k].j == pair.j)
+			return;
+	}
+	pairs->push_back(pair);
+}
+
+/* Starts with a caliper along edge 0 and its parallel partner on the farthest vertex. At each
+ * step the caliper whose next edge turns less is rolled onto that edge; when both edges are
+ * parallel both roll, and the four vertices of the two edges are all antipodal. */
+std::vector<struct antipodalPair> antipodalPairs(std::vector<struct point> &polygon) {
+	std::vector<struct antipodalPair> pairs;
+	int n = polygon.size();
+	if (n < 2)
+		return pairs;
+	if (n == 2) {
+		pairs.push_back({ 0, 1 });
+		return pairs;
+	}
+
+	struct vector e0 = edgeVector(polygon, 0);
+	int j = 1;
+	while (cross(e0, makeVectorFromPoints(polygon[0], polygon[(j + 1) % n])) > cross(e0, makeVectorFromPoints(polygon[0], polygon[j])))
+		j++;
+
+	// Half a turn finds every pair; by then i has reached where j started and j where i did
+	int end = j;
+	int i = 1;
+	addPair(&pairs, n, 0, j, START_PAIRS);
+	addPair(&pairs, n, 1, j, START_PAIRS);
+	if (cross(e0, edgeVector(polygon, j)) == 0) {
+		addPair(&pairs, n, 0, j + 1, START_PAIRS);
+		addPair(&pairs, n, 1, j + 1, START_PAIRS);
+		j++;
+	}
+	int start = pairs.size();
+
+	while (i < end || j < n) {
+		struct vector ei = edgeVector(polygon, i);
+		struct vector ej = edgeVector(polygon, j);
+		double turn = cross(ei, { -ej.x, -ej.y });
+
+		if (turn > 0) {
+			i++;
+		}
+		else if (turn < 0) {
+			j++;
+		}
+		else {
+			addPair(&pairs, n, i + 1, j, start);
+			addPair(&pairs, n, i, j + 1, start);
+			i++;
+			j++;
+		}
+		addPair(&pairs, n, i, j, start);
+	}
+
+	return pairs;
+}
+
+static struct orientedBox makeBox(struct point origin, struct vector axis, double minU, double maxU, double maxV) {
+	struct vector normal = { -axis.y, axis.x };
+	struct orientedBox box;
+	double u[4] = { minU, maxU, maxU, minU };
+	double v[4] = { 0, 0, maxV, maxV };
+
+	for (int k = 0; k < 4; k++)
+		box.corners[k] = { origin.x + axis.x * u[k] + normal.x * v[k], origin.y + axis.y * u[k] + normal.y * v[k] };
+	box.axis = axis;
+	box.length = maxU - minU;
+	box.breadth = maxV;
+	box.area = box.length * box.breadth;
+	box.perimeter = 2 * (box.length + box.breadth);
+	return box;
+}
+
+struct hullMetrics measurePolygon(std::vector<struct point> &polygon) {
+	struct hullMetrics metrics;
+	int n = polygon.size();
+	struct point first = n > 0 ? polygon[0] : point{ 0, 0 };
+
+	metrics.diameter = 0;
+	metrics.diameterEnds[0] = metrics.diameterEnds[1] = first;
+	metrics.width = 0;
+	metrics.widthNormal = { 0, 1 };
+	metrics.minAreaBox = metrics.minPerimeterBox = makeBox(first, { 1, 0 }, 0, 0, 0);
+	if (n < 2)
+		return metrics;
+
+	std::vector<struct antipodalPair> pairs = antipodalPairs(polygon);
+	for (int k = 0; k < pairs.size(); k++) {
+		double d = distance(polygon[pairs[k].i], polygon[pairs[k].j]);
+		if (d > metrics.diameter) {
+			metrics.diameter = d;
+			metrics.diameterEnds[0] = polygon[pairs[k].i];
+			metrics.diameterEnds[1] = polygon[pairs[k].j];
+		}
+	}
+
+	/* One rectangle per edge. right, top and left are the vertices farthest along the edge,
+	 * away from it and back along it; each only ever moves forward, so the loop is O(n). */
+	int edges = n == 2 ? 1 : n;
+	int right = 1, top = 1, left = 1;
+	metrics.width = DBL_MAX;
+	metrics.minAreaBox.area = DBL_MAX;
+	metrics.minPerimeterBox.perimeter = DBL_MAX;
+
+	for (int i = 0; i < edges; i++) {
+		struct vector e = edgeVector(polygon, i);
+		double length = hypot(e.x, e.y);
+		struct vector u = { e.x / length, e.y / length };
+		struct vector v = { -u.y, u.x };
+		struct point o = polygon[i];
+
+		while (dot(polygon[(right + 1) % n], u) > dot(polygon[right % n], u))
+			right++;
+		if (top < right)
+			top = right;
+		while (dot(polygon[(top + 1) % n], v) > dot(polygon[top % n], v))
+			top++;
+		if (left < top)
+			left = top;
+		while (dot(polygon[(left + 1) % n], u) < dot(polygon[left % n], u))
+			left++;
+
+		double maxU = dot(polygon[right % n], u) - dot(o, u);
+		double maxV = dot(polygon[top % n], v) - dot(o, v);
+		double minU = dot(polygon[left % n], u) - dot(o, u);
+
+		if (maxV < metrics.width) {
+			metrics.width = maxV;
+			metrics.widthNormal = v;
+		}
+
+		struct orientedBox box = makeBox(o, u, minU, maxU, maxV);
+		if (box.area < metrics.minAreaBox.area)
+			metrics.minAreaBox = box;
+		if (box.perimeter < metrics.minPerimeterBox.perimeter)
+			metrics.minPerimeterBox = box;
+	}
+
+	return metrics;
+}
+
+struct hullMetrics measureHull(ConvexHull *hull) {
+	std::vector<struct point> polygon = strictConvexPolygon(hull->getHull());
+	return measurePolygon(polygon);
+}
+
+void measureHulls(std::vector<ConvexHull *> &hulls, std::vector<struct hullMetrics> *metrics, int threads) {
+	if (threads <= 0)
+		threads = std::max(1, (int)std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, (int)hulls.size() / 64));
+
+	metrics->resize(hulls.size());
+	auto work = [&](int begin, int end) {
+		for (int i = begin; i < end; i++)
+			(*metrics)[i] = measureHull(hulls[i]);
+	};
+
+	// getHull builds the hull on first use, so every hull is built here before the threads share them
+	for (int i = 0; i < hulls.size(); i++)
+		hulls[i]->getHull();
+
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; t++)
+		workers.push_back(std::thread(work, (int)((long long)hulls.size() * t / threads), (int)((long long)hulls.size() * (t + 1) / threads)));
+	work(0, hulls.size() / threads);
+
+	for (int t = 0; t < workers.size(); t++)
+		workers[t].join();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include "DataTypes.h"
+#include "ConvexHull.h"
+
+/* Rotating calipers over a computed hull, all in O(h).
+ * A pair of parallel lines is rotated once around the hull, touching it on opposite sides.
+ * The vertex pairs they touch are the antipodal pairs, the widest of which gives the diameter;
+ * the closest the lines get while one lies along an edge is the width. Keeping two more
+ * lines at right angles to those gives every bounding rectangle with a side on a hull edge,
+ * which includes both the minimum area and the minimum perimeter rectangle.
+ */
+
+struct antipodalPair {
+	int i, j;		// indices into the polygon the pairs were computed for, i < j
+};
+
+struct orientedBox {
+	struct point corners[4];	// counter-clockwise
+	struct vector axis;			// unit direction of the first side
+	double length;				// along axis
+	double breadth;				// across axis
+	double area;
+	double perimeter;
+};
+
+struct hullMetrics {
+	double diameter;
+	struct point diameterEnds[2];
+	double width;
+	struct vector widthNormal;	// unit direction in which the hull is thinnest
+	struct orientedBox minAreaBox;
+	struct orientedBox minPerimeterBox;
+};
+
+/* polygon must be counter-clockwise with no repeated or collinear vertices, see strictConvexPolygon */
+std::vector<struct antipodalPair> antipodalPairs(std::vector<struct point> &polygon);
+struct hullMetrics measurePolygon(std::vector<struct point> &polygon);
+
+struct hullMetrics measureHull(ConvexHull *hull);
+/* Metrics of many hulls, split across up to threads threads (0 for one per core) */
+void measureHulls(std::vector<ConvexHull *> &hulls, std::vector<struct hullMetrics> *metrics, int threads = 0);
@@ -0,0 +1,214 @@
+#include "HullCodec.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+// The longest a 64-bit varint can be
+#define MAX_VARINT_BYTES 10
+// More vertices than this in one record can only be a corrupt count
+#define MAX_RECORD_VERTICES (1 << 28)
+// Keeps quantized coordinates, and the steps between them, inside 64 bits
+#define MAX_QUANTIZED 4.0e18
+
+static inline uint64_t zigzag(int64_t v) {
+	return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t u) {
+	return (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+}
+
+static inline uint8_t *writeVarint(uint8_t *p, uint64_t v) {
+	while (v >= 0x80) {
+		*p++ = (uint8_t)(v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (uint8_t)v;
+	return p;
+}
+
+/* Reads a varint that may run past end. Returns 1 if it was read, 0 if it runs past the end and
+ * -1 if it is longer than any 64-bit value. */
+static inline int readVarint(const uint8_t **p, const uint8_t *end, uint64_t *v) {
+	uint64_t value = 0;
+	const uint8_t *q = *p;
+	for (int shift = 0; shift < 7 * MAX_VARINT_BYTES; shift += 7) {
+		if (q == end)
+			return 0;
+		uint8_t b = *q++;
+		value |= (uint64_t)(b & 0x7f) << shift;
+		if (!(b & 0x80)) {
+			*p = q;
+			*v = value;
+			return 1;
+		}
+	}
+	return -1;
+}
+
+/* The same when the caller knows there are MAX_VARINT_BYTES left. Returns false if the varint
+ * is too long. */
+static inline bool readVarintUnchecked(const uint8_t **p, uint64_t *v) {
+	uint64_t value = 0;
+	const uint8_t *q = *p;
+	for (int shift = 0; shift < 7 * MAX_VARINT_BYTES; shift += 7) {
+		uint8_t b = *q++;
+		value |= (uint64_t)(b & 0x7f) << shift;
+		if (!(b & 0x80)) {
+			*p = q;
+			*v = value;
+			return true;
+		}
+	}
+	return false;
+}
+
+/* The header's fixed-size fields are little-endian whatever the host's byte order */
+static void writeLittleEndian(uint8_t *p, uint64_t v, int bytes) {
+	for (int i = 0; i < bytes; i++)
+		p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint64_t readLittleEndian(const uint8_t *p, int bytes) {
+	uint64_t v = 0;
+	for (int i = 0; i < bytes; i++)
+		v |= (uint64_t)p[i] << (8 * i);
+	return v;
+}
+
+/* Appends the record for n points, using words as scratch for the 2n zigzagged numbers */
+static void encodeRecord(const struct point *points, int n, double quantum, std::vector<int64_t> &words, std::vector<uint8_t> *out) {
+	words.resize(2 * (size_t)n);
+	double inverse = 1 / quantum;
+
+	for (int i = 0; i < n; i++) {
+		words[2 * i] = (int64_t)nearbyint(std::min(std::max(points[i].x * inverse, -MAX_QUANTIZED), MAX_QUANTIZED));
+		words[2 * i + 1] = (int64_t)nearbyint(std::min(std::max(points[i].y * inverse, -MAX_QUANTIZED), MAX_QUANTIZED));
+	}
+	// Steps from the previous vertex, last first so each still sees the absolute one before it
+	for (int i = 2 * n - 1; i >= 2; i--)
+		words[i] -= words[i - 2];
+
+	size_t start = out->size();
+	out->resize(start + MAX_VARINT_BYTES * (2 * (size_t)n + 1));
+	uint8_t *p = out->data() + start;
+	p = writeVarint(p, (uint64_t)n);
+	for (int i = 0; i < 2 * n; i++)
+		p = writeVarint(p, zigzag(words[i]));
+	out->resize(p - out->data());
+}
+
+void beginHullStream(double quantum, std::vector<uint8_t> *out) {
+	uint8_t header[HULL_CODEC_HEADER_SIZE];
+	writeLittleEndian(header, HULL_CODEC_MAGIC, 4);
+	header[4] = HULL_CODEC_VERSION;
+	uint64_t bits;
+	memcpy(&bits, &quantum, 8);
+	writeLittleEndian(header + 5, bits, 8);
+	out->insert(out->end(), header, header + HULL_CODEC_HEADER_SIZE);
+}
+
+void encodeHull(const std::vector<struct point> &hull, double quantum, std::vector<uint8_t> *out) {
+	std::vector<int64_t> words;
+	encodeRecord(hull.data(), hull.size(), quantum, words, out);
+}
+
+void encodeHulls(const struct hullBatch &batch, double quantum, std::vector<uint8_t> *out) {
+	std::vector<int64_t> words;
+	for (int s = 0; s + 1 < batch.offsets.size(); s++)
+		encodeRecord(batch.points.data() + batch.offsets[s], batch.offsets[s + 1] - batch.offsets[s], quantum, words, out);
+}
+
+bool openHullStream(const uint8_t *data, size_t size, struct hullDecoder *decoder) {
+	if (size < HULL_CODEC_HEADER_SIZE)
+		return false;
+	if (readLittleEndian(data, 4) != HULL_CODEC_MAGIC || data[4] != HULL_CODEC_VERSION)
+		return false;
+
+	decoder->data = data;
+	decoder->size = size;
+	decoder->position = HULL_CODEC_HEADER_SIZE;
+	uint64_t bits = readLittleEndian(data + 5, 8);
+	memcpy(&decoder->quantum, &bits, 8);
+	return decoder->quantum > 0;
+}
+
+/* Decodes the record at the decoder's position onto the end of hull, from index at. Nothing
+ * is consumed unless the whole record is there. */
+static enum HullDecodeStatus decodeRecord(struct hullDecoder *decoder, std::vector<struct point> *hull, size_t at) {
+	const uint8_t *p = decoder->data + decoder->position;
+	const uint8_t *end = decoder->data + decoder->size;
+
+	uint64_t count;
+	int read = readVarint(&p, end, &count);
+	if (read <= 0)
+		return read == 0 ? HULL_INCOMPLETE : HULL_CORRUPT;
+	if (count > MAX_RECORD_VERTICES)
+		return HULL_CORRUPT;
+	int n = (int)count;
+	// Every number takes at least a byte
+	if ((size_t)(end - p) < 2 * (size_t)n)
+		return HULL_INCOMPLETE;
+
+	hull->resize(at + n);
+	struct point *points = hull->data() + at;
+	double quantum = decoder->quantum;
+	// Summed unsigned, where a corrupt record wraps around rather than overflowing
+	uint64_t x = 0, y = 0;
+	uint64_t vx, vy;
+
+	if ((size_t)(end - p) >= MAX_VARINT_BYTES * 2 * (size_t)n) {
+		for (int i = 0; i < n; i++) {
+			if (!readVarintUnchecked(&p, &vx) || !readVarintUnchecked(&p, &vy)) {
+				hull->resize(at);
+				return HULL_CORRUPT;
+			}
+			x += (uint64_t)unzigzag(vx);
+			y += (uint64_t)unzigzag(vy);
+			points[i] = { (double)(int64_t)x * quantum, (double)(int64_t)y * quantum };
+		}
+	}
+	else {
+		for (int i = 0; i < n; i++) {
+			read = readVarint(&p, end, &vx);
+			if (read > 0)
+				read = readVarint(&p, end, &vy);
+			if (read <= 0) {
+				hull->resize(at);
+				return read == 0 ? HULL_INCOMPLETE : HULL_CORRUPT;
+			}
+			x += (uint64_t)unzigzag(vx);
+			y += (uint64_t)unzigzag(vy);
+			points[i] = { (double)(int64_t)x * quantum, (double)(int64_t)y * quantum };
+		}
+	}
+
+	decoder->position = p - decoder->data;
+	return HULL_DECODED;
+}
+
+enum HullDecodeStatus decodeHull(struct hullDecoder *decoder, std::vector<struct point> *hull) {
+	if (decoder->position >= decoder->size)
+		return HULL_INCOMPLETE;
+	enum HullDecodeStatus status = decodeRecord(decoder, hull, 0);
+	if (status != HULL_DECODED)
+		hull->clear();
+	return status;
+}
+
+enum HullDecodeStatus decodeHulls(struct hullDecoder *decoder, struct hullBatch *batch) {
+	if (batch->offsets.size() == 0)
+		batch->offsets.push_back(0);
+
+	while (decoder->position < decoder->size) {
+		size_t at = batch->points.size();
+		enum HullDecodeStatus status = decodeRecord(decoder, &batch->points, at);
+		if (status != HULL_DECODED) {
+			batch->points.resize(at);
+			return status;
+		}
+		batch->offsets.push_back(batch->points.size());
+	}
+
+	return HULL_DECODED;
+}
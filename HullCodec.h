@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "DataTypes.h"
+#include "BatchHull.h"
+
+/* Compact binary encoding of hulls for storage and transfer.
+ * A stream starts with a header holding the quantum, the grid spacing every coordinate is
+ * rounded to, and is followed by one record per hull: the vertex count, the first vertex, then
+ * the step from each vertex to the next. Coordinates are stored as whole multiples of the
+ * quantum, and every number is zigzag-encoded (so small negatives stay small) and written as a
+ * varint, seven bits per byte. Neighbouring hull vertices are close together, so most steps take
+ * one or two bytes per coordinate against eight for a double.
+ * Rounding to the grid moves each vertex by at most half the quantum. Whole-number coordinates,
+ * like screen points, come back exactly with a quantum of 1. Coordinates beyond 4e18 quanta from
+ * the origin are clamped there, so the quantum has to suit the size of the coordinates.
+ * The encoder quantizes and differences a whole hull at a time in flat loops with no branches,
+ * which the compiler can vectorize, before writing the bytes. The decoder reads straight into
+ * the points, without bounds checks whenever the buffer has room for the longest possible record.
+ */
+
+#define HULL_CODEC_MAGIC 0x51484843	// "CHHQ" in the file
+#define HULL_CODEC_VERSION 1
+#define HULL_CODEC_HEADER_SIZE 13	// magic, version, quantum, little-endian
+
+enum HullDecodeStatus {
+	HULL_DECODED,
+	HULL_INCOMPLETE,		// the next record isn't all there yet; nothing was consumed
+	HULL_CORRUPT
+};
+
+/* Where a decoder is in a stream. The bytes stay the caller's; to stream from a file, decode
+ * until HULL_INCOMPLETE, then move the unread bytes from position on to the front of the buffer,
+ * read more after them, and carry on with position at 0. */
+struct hullDecoder {
+	const uint8_t *data;
+	size_t size;
+	size_t position;
+	double quantum;
+};
+
+void beginHullStream(double quantum, std::vector<uint8_t> *out);
+/* Appends one hull, as getHull returns it, to a stream begun with the same quantum */
+void encodeHull(const std::vector<struct point> &hull, double quantum, std::vector<uint8_t> *out);
+/* Appends every hull of a batch, as batchHulls returns them */
+void encodeHulls(const struct hullBatch &batch, double quantum, std::vector<uint8_t> *out);
+
+/* Reads the header. Returns false if the data doesn't start with one. */
+bool openHullStream(const uint8_t *data, size_t size, struct hullDecoder *decoder);
+/* Decodes the next hull into hull, replacing what was there but keeping its memory, in the
+ * same order it was encoded in, so it can be handed to ConvexHull or used as a getHull result */
+enum HullDecodeStatus decodeHull(struct hullDecoder *decoder, std::vector<struct point> *hull);
+/* Decodes every whole record left, appending them to the batch. Returns HULL_INCOMPLETE if the
+ * data ends partway through a record, which is left unread. */
+enum HullDecodeStatus decodeHulls(struct hullDecoder *decoder, struct hullBatch *batch);
@@ -0,0 +1,98 @@
+#include "HullProfiler.h"
+
+#ifdef HULL_PROFILING
+
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <vector>
+
+struct traceEvent {
+	const char *name;
+	long long start;	// microseconds since the first event
+	long long duration;
+	size_t thread;
+};
+
+static const char *counterNames[HULL_COUNTER_COUNT] = {
+	"farthestScans", "pointsVisited", "hullInsertions", "hullRescans", "containsTests", "allocations"
+};
+
+static std::atomic<long long> counters[HULL_COUNTER_COUNT];
+static std::vector<struct traceEvent> events;
+static std::mutex eventsLock;
+static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+static long long microsecondsSinceEpoch(std::chrono::steady_clock::time_point t) {
+	return std::chrono::duration_cast<std::chrono::microseconds>(t - epoch).count();
+}
+
+void hullProfilerCount(enum HullCounter counter, long long amount) {
+	counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+long long hullProfilerGetCount(enum HullCounter counter) {
+	return counters[counter].load(std::memory_order_relaxed);
+}
+
+void hullProfilerReset() {
+	for (int i = 0; i < HULL_COUNTER_COUNT; i++)
+		counters[i] = 0;
+
+	std::lock_guard<std::mutex> guard(eventsLock);
+	events.clear();
+}
+
+HullProfileScope::HullProfileScope(const char *name) {
+	this->name = name;
+	this->start = std::chrono::steady_clock::now();
+}
+
+HullProfileScope::~HullProfileScope() {
+	record();
+}
+
+void HullProfileScope::next(const char *name) {
+	record();
+	this->name = name;
+	this->start = std::chrono::steady_clock::now();
+}
+
+void HullProfileScope::record() {
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	struct traceEvent e = { name, microsecondsSinceEpoch(start), microsecondsSinceEpoch(end) - microsecondsSinceEpoch(start),
+		std::hash<std::thread::id>()(std::this_thread::get_id()) % 100000 };
+
+	std::lock_guard<std::mutex> guard(eventsLock);
+	events.push_back(e);
+}
+
+bool hullProfilerWriteTrace(const char *path) {
+	FILE *f = fopen(path, "w");
+	if (!f)
+		return false;
+
+	std::lock_guard<std::mutex> guard(eventsLock);
+	long long last = 0;
+
+	fprintf(f, "{\"traceEvents\":[\n");
+	for (int i = 0; i < events.size(); i++) {
+		fprintf(f, "{\"name\":\"%s\",\"cat\":\"hull\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%zu},\n",
+			events[i].name, events[i].start, events[i].duration, events[i].thread);
+		if (events[i].start + events[i].duration > last)
+			last = events[i].start + events[i].duration;
+	}
+
+	// The counters are emitted as a single sample at the end of the trace
+	fprintf(f, "{\"name\":\"hull counters\",\"ph\":\"C\",\"ts\":%lld,\"pid\":1,\"args\":{", last);
+	for (int i = 0; i < HULL_COUNTER_COUNT; i++)
+		fprintf(f, "%s\"%s\":%lld", i ? "," : "", counterNames[i], hullProfilerGetCount((enum HullCounter)i));
+	fprintf(f, "}}\n],\"displayTimeUnit\":\"ms\"}\n");
+
+	fclose(f);
+	return true;
+}
+
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+/* Opt-in instrumentation for hull construction.
+ * Define HULL_PROFILING (e.g. in the project's preprocessor definitions) to enable it.
+ * When it is not defined every HULL_PROFILE_* macro expands to nothing, so the
+ * hot paths in ConvexHull.cpp and DataTypes.cpp pay no cost at all.
+ */
+
+#ifdef HULL_PROFILING
+
+#include <chrono>
+
+enum HullCounter {
+	FARTHEST_SCANS,		// calls to getPointFarthestFromEdge
+	POINTS_VISITED,		// points examined by those calls
+	HULL_INSERTIONS,	// vertices inserted into a hull by getHull
+	HULL_RESCANS,		// edges scanned again because of the backtracking in getHull
+	CONTAINS_TESTS,		// calls to containsPoint
+	ALLOCATIONS,		// point vectors allocated by the hull code
+	HULL_COUNTER_COUNT
+};
+
+void hullProfilerCount(enum HullCounter counter, long long amount);
+long long hullProfilerGetCount(enum HullCounter counter);
+void hullProfilerReset();
+
+/* Records a complete ("ph":"X") trace event covering the lifetime of the object.
+ * next() closes the current event and opens another, which lets a function be split
+ * into consecutive phases without adding nested blocks. */
+class HullProfileScope
+{
+private:
+	const char *name;
+	std::chrono::steady_clock::time_point start;
+
+	void record();
+public:
+	HullProfileScope(const char *name);
+	~HullProfileScope();
+	void next(const char *name);
+};
+
+/* Writes every recorded event plus the current counter values as a Chrome trace
+ * (chrome://tracing or ui.perfetto.dev). Returns false if the file can't be opened. */
+bool hullProfilerWriteTrace(const char *path);
+
+#define HULL_PROFILE_CONCAT2(a, b) a##b
+#define HULL_PROFILE_CONCAT(a, b) HULL_PROFILE_CONCAT2(a, b)
+#define HULL_PROFILE_COUNT(counter, amount) hullProfilerCount(counter, amount)
+#define HULL_PROFILE_SCOPE(name) HullProfileScope HULL_PROFILE_CONCAT(hullProfileScope, __LINE__)(name)
+#define HULL_PROFILE_PHASES(first) HullProfileScope hullProfilePhases(first)
+#define HULL_PROFILE_NEXT_PHASE(name) hullProfilePhases.next(name)
+
+#else
+
+#define HULL_PROFILE_COUNT(counter, amount) ((void)0)
+#define HULL_PROFILE_SCOPE(name) ((void)0)
+#define HULL_PROFILE_PHASES(first) ((void)0)
+#define HULL_PROFILE_NEXT_PHASE(name) ((void)0)
+
+#endif
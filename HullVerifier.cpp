@@ -0,0 +1,612 @@
+#include "HullVerifier.h"
+#include "ConvexHull.h"
+#include "Converter.h"
+#include "GJK.h"
+#include "EPA.h"
+#include "BatchHull.h"
+#include "TransformedHull.h"
+#include "PointGenerator.h"
+#include "HullCodec.h"
+#include "HalfPlane.h"
+#include "CollisionWorld.h"
+#include "ConvexHull3D.h"
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+static bool lessXY(struct point a, struct point b) {
+	return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+static std::vector<struct point> getHullEngine(std::vector<struct point> &points) {
+	ConvexHull hull(points);
+	std::vector<struct point> *result = hull.getHull();
+	return *result;
+}
+
+static std::vector<struct point> monotoneChainEngine(std::vector<struct point> &points) {
+	ConvexHull hull(points, HULL_MONOTONE_CHAIN);
+	return *hull.getHull();
+}
+
+/* Sorted points form an x-monotone polyline, which is simple, so they are valid Melkman input */
+static std::vector<struct point> melkmanEngine(std::vector<struct point> &points) {
+	std::vector<struct point> sorted = points;
+	std::sort(sorted.begin(), sorted.end(), lessXY);
+	ConvexHull hull(sorted, HULL_MELKMAN);
+	return *hull.getHull();
+}
+
+static std::vector<struct point> batchEngine(std::vector<struct point> &points) {
+	std::vector<int> offsets = { 0, (int)points.size() };
+	struct hullBatch batch;
+	batchHulls(points, offsets, &batch, 1);
+	return batch.points;
+}
+
+const struct hullEngine hullEngines[] = {
+	{ "getHull", getHullEngine, true },
+	{ "monotoneChain", monotoneChainEngine, false },
+	{ "melkman", melkmanEngine, false },
+	{ "batch", batchEngine, false },
+};
+
+const int hullEngineCount = sizeof(hullEngines) / sizeof(hullEngines[0]);
+
+static double cross(struct point o, struct point a, struct point b) {
+	return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+static double largestCoordinate(std::vector<struct point> &points) {
+	double largest = 1;
+	for (int i = 0; i < points.size(); i++)
+		largest = std::max(largest, std::max(fabs(points[i].x), fabs(points[i].y)));
+	return largest;
+}
+
+/* Andrew's monotone chain, counter-clockwise, without collinear vertices */
+std::vector<struct point> referenceHull(std::vector<struct point> points) {
+	std::sort(points.begin(), points.end(), lessXY);
+	points.erase(std::unique(points.begin(), points.end(),
+		[](struct point a, struct point b) { return a.x == b.x && a.y == b.y; }), points.end());
+
+	if (points.size() < 3)
+		return points;
+
+	std::vector<struct point> hull(2 * points.size());
+	int k = 0;
+
+	for (int i = 0; i < points.size(); i++) {
+		while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0)
+			k--;
+		hull[k++] = points[i];
+	}
+
+	for (int i = points.size() - 2, lower = k + 1; i >= 0; i--) {
+		while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i]) <= 0)
+			k--;
+		hull[k++] = points[i];
+	}
+
+	hull.resize(k - 1);
+	return hull;
+}
+
+static double distanceToSegment(struct point p, struct point a, struct point b) {
+	struct vector ab = makeVectorFromPoints(a, b);
+	struct vector ap = makeVectorFromPoints(a, p);
+	double length = dotProduct(ab, ab);
+	double t = length > 0 ? std::max(0.0, std::min(1.0, dotProduct(ap, ab) / length)) : 0;
+	return hypot(a.x + ab.x * t - p.x, a.y + ab.y * t - p.y);
+}
+
+/* True if p is inside or within tolerance of a counter-clockwise reference hull */
+bool referenceContains(std::vector<struct point> *hull, struct point p, double tolerance) {
+	if (hull->size() == 0)
+		return false;
+	if (hull->size() == 1)
+		return hypot(p.x - (*hull)[0].x, p.y - (*hull)[0].y) <= tolerance;
+
+	bool inside = hull->size() >= 3;
+	for (int i = 0; i < hull->size(); i++) {
+		struct point a = (*hull)[i];
+		struct point b = (*hull)[(i + 1) % hull->size()];
+		if (distanceToSegment(p, a, b) <= tolerance)
+			return true;
+		if (cross(a, b, p) < 0)
+			inside = false;
+	}
+
+	return inside;
+}
+
+std::vector<struct point> canonicalHull(std::vector<struct point> hull, double tolerance) {
+	std::vector<struct point> result;
+
+	for (int i = 0; i < hull.size(); i++) {
+		if (result.size() > 0 && fabs(result.back().x - hull[i].x) <= tolerance && fabs(result.back().y - hull[i].y) <= tolerance)
+			continue;
+		result.push_back(hull[i]);
+	}
+	while (result.size() > 1 && fabs(result.back().x - result[0].x) <= tolerance && fabs(result.back().y - result[0].y) <= tolerance)
+		result.pop_back();
+
+	double area = 0;
+	for (int i = 0; i < result.size(); i++)
+		area += result[i].x * result[(i + 1) % result.size()].y - result[(i + 1) % result.size()].x * result[i].y;
+	if (area < 0)
+		std::reverse(result.begin(), result.end());
+
+	// Drop vertices lying on the segment between their neighbours
+	bool removed = true;
+	while (removed && result.size() > 2) {
+		removed = false;
+		for (int i = 0; i < result.size(); i++) {
+			struct point previous = result[(i + result.size() - 1) % result.size()];
+			struct point next = result[(i + 1) % result.size()];
+			if (distanceToSegment(result[i], previous, next) <= tolerance) {
+				result.erase(result.begin() + i);
+				removed = true;
+				break;
+			}
+		}
+	}
+
+	if (result.size() > 0)
+		std::rotate(result.begin(), std::min_element(result.begin(), result.end(),
+			[](struct point a, struct point b) { return a.y < b.y || (a.y == b.y && a.x < b.x); }), result.end());
+
+	return result;
+}
+
+bool sameHull(std::vector<struct point> a, std::vector<struct point> b, double tolerance) {
+	a = canonicalHull(a, tolerance);
+	b = canonicalHull(b, tolerance);
+
+	if (a.size() != b.size())
+		return false;
+
+	for (int i = 0; i < a.size(); i++) {
+		if (fabs(a[i].x - b[i].x) > tolerance || fabs(a[i].y - b[i].y) > tolerance)
+			return false;
+	}
+
+	return true;
+}
+
+std::vector<struct point> generatePointSet(enum PointSetKind kind, int count, uint64_t seed) {
+	std::mt19937_64 rng(seed);
+	std::uniform_real_distribution<double> unit(-1.0, 1.0);
+	std::vector<struct point> points;
+
+	if (count < 1)
+		count = 1;
+
+	switch (kind) {
+	case UNIFORM_SET:
+		for (int i = 0; i < count; i++)
+			points.push_back({ unit(rng) * 1000, unit(rng) * 1000 });
+		break;
+
+	case DUPLICATE_SET: {
+		int distinct = 1 + rng() % 4;
+		for (int i = 0; i < distinct; i++)
+			points.push_back({ (double)(rng() % 100), (double)(rng() % 100) });
+		for (int i = distinct; i < count; i++)
+			points.push_back(points[rng() % distinct]);
+		break;
+	}
+
+	case COLLINEAR_SET: {
+		int lines = 1 + rng() % 3;
+		for (int i = 0; i < count; i++) {
+			uint64_t line = rng() % lines;
+			double t = (double)(rng() % 64);
+			points.push_back({ 10.0 * line + t * (line + 1), 5.0 * line - t * line + t });
+		}
+		break;
+	}
+
+	case HUGE_SET:
+		for (int i = 0; i < count; i++)
+			points.push_back({ 1e12 + (double)(rng() % 2000000) * 1e6, -1e12 + (double)(rng() % 2000000) * 1e6 });
+		break;
+
+	case SCREEN_GRID_SET: {
+		// The same workload as PaintQuickhull on a 1920x1080 client area
+		int rightLimit = 1920 - 200 - 500;
+		int bottomLimit = 1080 - 200 - 150;
+		points = generatePoints(makePointWorkload(UNIFORM_POINTS, rng(), { 500, 150 }, { 500.0 + rightLimit, 150.0 + bottomLimit }, true), count);
+		break;
+	}
+
+	default:
+		points.push_back({ 0, 0 });
+	}
+
+	std::shuffle(points.begin(), points.end(), rng);
+	return points;
+}
+
+static int report(FILE *log, const char *check, std::vector<struct point> *input, std::vector<struct point> *expected, std::vector<struct point> *actual) {
+	if (log) {
+		fprintf(log, "FAILED: %s\n", check);
+		if (input)
+			printPoints(log, input, "Input");
+		if (expected)
+			printPoints(log, expected, "Expected");
+		if (actual)
+			printPoints(log, actual, "Actual");
+	}
+	return 1;
+}
+
+/* The Minkowski operations convert through grid space and back, which comes out as
+ * a + b - origin for a sum and a - b + origin for a difference in screen space */
+static std::vector<struct point> minkowskiOracle(std::vector<struct point> &set1, std::vector<struct point> &set2, bool sum, struct point origin) {
+	std::vector<struct point> points;
+
+	for (int i = 0; i < set1.size(); i++) {
+		for (int j = 0; j < set2.size(); j++) {
+			if (sum)
+				points.push_back({ set1[i].x + set2[j].x - origin.x, set1[i].y + set2[j].y - origin.y });
+			else
+				points.push_back({ set1[i].x - set2[j].x + origin.x, set1[i].y - set2[j].y + origin.y });
+		}
+	}
+
+	return referenceHull(points);
+}
+
+/* Sutherland-Hodgman: clips the counter-clockwise polygon subject by each edge of clip in turn */
+static double intersectionAreaOracle(std::vector<struct point> subject, std::vector<struct point> &clip) {
+	for (int i = 0; i < clip.size() && subject.size() > 0; i++) {
+		struct point a = clip[i], b = clip[(i + 1) % clip.size()];
+		std::vector<struct point> clipped;
+		for (int k = 0; k < subject.size(); k++) {
+			struct point p = subject[k], q = subject[(k + 1) % subject.size()];
+			double sp = cross(a, b, p), sq = cross(a, b, q);
+			if (sp >= 0)
+				clipped.push_back(p);
+			if ((sp > 0 && sq < 0) || (sp < 0 && sq > 0))
+				clipped.push_back({ p.x + (q.x - p.x) * sp / (sp - sq), p.y + (q.y - p.y) * sp / (sp - sq) });
+		}
+		subject = clipped;
+	}
+
+	double area = 0;
+	for (int i = 0; i < subject.size(); i++)
+		area += subject[i].x * subject[(i + 1) % subject.size()].y - subject[i].y * subject[(i + 1) % subject.size()].x;
+	return area / 2;
+}
+
+int verifyPointSets(std::vector<struct point> &set1, std::vector<struct point> &set2, FILE *log, int *baselineFailures) {
+	int failures = 0, baseline = 0;
+	double tolerance = 1e-9 * std::max(largestCoordinate(set1), largestCoordinate(set2));
+	std::vector<struct point> expected = referenceHull(set1);
+
+	for (int e = 0; e < hullEngineCount; e++) {
+		std::vector<struct point> actual = hullEngines[e].build(set1);
+		if (!sameHull(expected, actual, tolerance))
+			(hullEngines[e].baseline ? baseline : failures) += report(log, hullEngines[e].name, &set1, &expected, &actual);
+	}
+
+	/* The encoded hull comes back in the same order with every vertex within half a quantum. A
+	 * power of two quantum keeps the rounding exact, so that bound is tight. The encoder clamps
+	 * coordinates beyond its 64-bit range, so the quantum grows with the coordinates. */
+	double quantum = 1.0 / 1024;
+	while (largestCoordinate(set1) / quantum > 1e18)
+		quantum *= 2;
+	std::vector<uint8_t> encoded;
+	beginHullStream(quantum, &encoded);
+	encodeHull(expected, quantum, &encoded);
+	struct hullDecoder decoder;
+	std::vector<struct point> decoded;
+	bool roundTrip = openHullStream(encoded.data(), encoded.size(), &decoder) && decodeHull(&decoder, &decoded) == HULL_DECODED &&
+		decoder.position == encoded.size() && decoded.size() == expected.size();
+	for (int i = 0; i < decoded.size() && roundTrip; i++) {
+		if (fabs(decoded[i].x - expected[i].x) > quantum / 2 || fabs(decoded[i].y - expected[i].y) > quantum / 2)
+			roundTrip = false;
+	}
+	if (!roundTrip)
+		failures += report(log, "hull codec", &set1, &expected, &decoded);
+
+	/* containsPoint against the reference, skipping probes too close to the boundary to call.
+	 * containsPoint skips zero length edges, so it is only meaningful for hulls with area. */
+	ConvexHull hull(set1);
+	hull.getHull();
+	for (int i = 0; i < set2.size() && expected.size() >= 3; i++) {
+		struct point probe = set2[i];
+		if (referenceContains(&expected, probe, tolerance * 16) != referenceContains(&expected, probe, 0))
+			continue;
+		if (hull.containsPoint(probe) != referenceContains(&expected, probe, 0)) {
+			std::vector<struct point> probes = { probe };
+			baseline += report(log, "containsPoint", &set1, &expected, &probes);
+		}
+	}
+
+	// Minkowski sum, difference and the GJK origin test, all on the original code
+	Converter conv(1920, 1080);
+	struct point origin = { 960, 540 };
+	ConvexHull hull1(set1);
+	ConvexHull hull2(set2);
+	double minkowskiTolerance = tolerance * 4;
+
+	for (int sum = 0; sum < 2; sum++) {
+		ConvexHull *minkowski = sum ? hull1.minkowskiSum(&hull1, &hull2, &conv) : hull1.minkowskiDifference(&hull1, &hull2, &conv);
+		std::vector<struct point> expectedMinkowski = minkowskiOracle(set1, set2, sum, origin);
+		std::vector<struct point> actualMinkowski = *minkowski->getHull();
+
+		if (!sameHull(expectedMinkowski, actualMinkowski, minkowskiTolerance))
+			baseline += report(log, sum ? "minkowskiSum" : "minkowskiDifference", &set1, &expectedMinkowski, &actualMinkowski);
+
+		if (!sum && expectedMinkowski.size() >= 3 && referenceContains(&expectedMinkowski, origin, minkowskiTolerance * 16) == referenceContains(&expectedMinkowski, origin, 0) &&
+			minkowski->containsPoint(origin) != referenceContains(&expectedMinkowski, origin, 0))
+			baseline += report(log, "GJK origin test", &set1, &expectedMinkowski, &set2);
+
+		delete minkowski;
+	}
+
+	/* The same through TransformedHull, with the second hull built shifted and scaled down and
+	 * its transform undoing that, so the merge has to account for both. The local hulls use
+	 * the monotone chain so that only the transforms and the merge are under test here. */
+	TransformedHull transformed1(set1, HULL_MONOTONE_CHAIN);
+	std::vector<struct point> shrunk(set2.size());
+	for (int i = 0; i < set2.size(); i++)
+		shrunk[i] = { (set2[i].x - 100) / 4, (set2[i].y + 50) / 4 };
+	TransformedHull transformed2(shrunk, HULL_MONOTONE_CHAIN);
+	transformed2.setTransform({ 4, { 100, -50 } });
+	for (int sum = 0; sum < 2; sum++) {
+		TransformedHull *minkowski = sum ? TransformedHull::minkowskiSum(&transformed1, &transformed2, &conv) : TransformedHull::minkowskiDifference(&transformed1, &transformed2, &conv);
+		std::vector<struct point> expectedMinkowski = minkowskiOracle(set1, set2, sum, origin);
+		std::vector<struct point> actualMinkowski = minkowski->getHull();
+
+		if (!sameHull(expectedMinkowski, actualMinkowski, minkowskiTolerance))
+			failures += report(log, sum ? "transformed minkowskiSum" : "transformed minkowskiDifference", &set1, &expectedMinkowski, &actualMinkowski);
+		delete minkowski;
+	}
+
+	/* GJK and EPA on the support functions against the difference oracle, only when both hulls
+	 * came out right, since they work from them. The penetration depth is the distance from the
+	 * origin to the nearest edge of the difference. */
+	std::vector<struct point> difference = minkowskiOracle(set1, set2, false, { 0, 0 });
+	struct point zero = { 0, 0 };
+	if (difference.size() >= 3 && sameHull(referenceHull(set1), *hull1.getHull(), tolerance) && sameHull(referenceHull(set2), *hull2.getHull(), tolerance) &&
+		referenceContains(&difference, zero, minkowskiTolerance * 16) == referenceContains(&difference, zero, 0)) {
+		bool overlapping = referenceContains(&difference, zero, 0);
+		if (gjkIntersect(&hull1, &hull2) != overlapping)
+			failures += report(log, "gjkIntersect", &set1, &difference, &set2);
+
+		double depth = DBL_MAX;
+		for (int i = 0; i < difference.size(); i++)
+			depth = std::min(depth, distanceToSegment(zero, difference[i], difference[(i + 1) % difference.size()]));
+
+		struct epaResult epa;
+		hullPenetration(&hull1, &hull2, &epa);
+		if (overlapping && fabs(epa.depth - depth) > minkowskiTolerance * 16)
+			failures += report(log, "epaPenetration", &set1, &difference, &set2);
+	}
+
+	// Intersection area, under the same condition that both hulls are right
+	std::vector<struct point> expected2 = referenceHull(set2);
+	if (expected.size() >= 3 && expected2.size() >= 3 && sameHull(expected, *hull1.getHull(), tolerance) && sameHull(expected2, *hull2.getHull(), tolerance)) {
+		double area = intersectionAreaOracle(expected, expected2);
+		double areaTolerance = 1e-7 * (1 + area);
+		ConvexHull *overlap = hull1.intersection(&hull1, &hull2);
+		std::vector<struct point> overlapHull = overlap ? *overlap->getHull() : std::vector<struct point>();
+
+		if (fabs(hull1.intersectionArea(&hull1, &hull2) - area) > areaTolerance || (overlap == NULL) != (area <= areaTolerance))
+			failures += report(log, "intersection", &set1, &expected2, &overlapHull);
+		delete overlap;
+	}
+
+	if (baselineFailures)
+		*baselineFailures += baseline;
+	return failures;
+}
+
+int verifyDegenerateRegions(FILE *log) {
+	struct degenerateCase {
+		const char *check;
+		double bound;
+		std::vector<struct halfPlane> planes;
+		std::vector<struct point> expected;
+	};
+	const struct degenerateCase cases[] = {
+		{ "halfPlaneIntersection point", 10,
+			{ { { 1, 0 }, { 0, 1 } }, { { 1, 0 }, { 0, -1 } }, { { 0, 2 }, { -1, 0 } }, { { 0, 2 }, { 1, 0 } } },
+			{ { 1, 2 } } },
+		{ "halfPlaneIntersection horizontal segment", 10,
+			{ { { 0, 0 }, { 1, 0 } }, { { 0, 0 }, { -1, 0 } } },
+			{ { -10, 0 }, { 10, 0 } } },
+		{ "halfPlaneIntersection diagonal segment", 10,
+			{ { { 0, 0 }, { 1, 1 } }, { { 0, 0 }, { -1, -1 } }, { { -2, 0 }, { 0, -1 } }, { { 3, 0 }, { 0, 1 } } },
+			{ { -2, -2 }, { 3, 3 } } },
+		{ "halfPlaneIntersection slanted segment", 10,
+			{ { { 0, 0 }, { 3, 1 } }, { { 0, 0 }, { -3, -1 } } },
+			{ { -10, -10.0 / 3 }, { 10, 10.0 / 3 } } },
+		{ "halfPlaneIntersection separated parallel", 10,
+			{ { { 0, 1 }, { 1, 0 } }, { { 0, 0 }, { -1, 0 } } },
+			{} },
+		// Not degenerate, but small against the default bound, which mustn't loosen the tolerances
+		{ "halfPlaneIntersection unit square", HALF_PLANE_DEFAULT_BOUND,
+			{ { { 0, 0 }, { 1, 0 } }, { { 1, 0 }, { 0, 1 } }, { { 1, 1 }, { -1, 0 } }, { { 0, 1 }, { 0, -1 } } },
+			{ { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } } }
+	};
+
+	int failures = 0;
+	for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		std::vector<struct point> actual = halfPlaneIntersection(cases[i].planes, cases[i].bound);
+		std::vector<struct point> expected = cases[i].expected;
+		if (actual.size() != expected.size() || !sameHull(expected, actual, 1e-9))
+			failures += report(log, cases[i].check, NULL, &expected, &actual);
+	}
+	return failures;
+}
+
+int verifyCollisionWorld(int bodies, int threads, uint64_t seed, FILE *log) {
+	std::mt19937_64 rng(seed);
+	std::uniform_real_distribution<double> unit(-1.0, 1.0);
+
+	// Packed densely enough that the narrow phase has pairs for every thread
+	std::vector<ConvexHull *> hulls;
+	for (int i = 0; i < bodies; i++) {
+		struct point centre = { unit(rng) * 1000, unit(rng) * 1000 };
+		double radius = 10 + 30 * fabs(unit(rng));
+		std::vector<struct point> points;
+		int count = 3 + rng() % 10;
+		for (int j = 0; j < count; j++)
+			points.push_back({ centre.x + unit(rng) * radius, centre.y + unit(rng) * radius });
+		hulls.push_back(new ConvexHull(points));
+	}
+
+	// The threaded world steps first, so it is the first to query the hulls' support
+	CollisionWorld threaded(threads), single(1);
+	for (int i = 0; i < hulls.size(); i++) {
+		threaded.add(hulls[i]);
+		single.add(hulls[i]);
+	}
+
+	std::vector<struct collisionPair> threadedCandidates, threadedContacts, singleCandidates, singleContacts;
+	threaded.step(&threadedCandidates, &threadedContacts);
+	single.step(&singleCandidates, &singleContacts);
+
+	int failures = 0;
+	bool same = threadedCandidates.size() == singleCandidates.size() && threadedContacts.size() == singleContacts.size();
+	for (int i = 0; same && i < threadedCandidates.size(); i++)
+		same = threadedCandidates[i].a == singleCandidates[i].a && threadedCandidates[i].b == singleCandidates[i].b;
+	for (int i = 0; same && i < threadedContacts.size(); i++)
+		same = threadedContacts[i].a == singleContacts[i].a && threadedContacts[i].b == singleContacts[i].b;
+	if (!same) {
+		if (log)
+			fprintf(log, "FAILED: CollisionWorld with %d threads found %d candidates and %d contacts, against %d and %d on one\n",
+				threads, (int)threadedCandidates.size(), (int)threadedContacts.size(), (int)singleCandidates.size(), (int)singleContacts.size());
+		failures++;
+	}
+
+	for (int i = 0; i < hulls.size(); i++)
+		delete hulls[i];
+	return failures;
+}
+
+int verifyFlatHulls3D(int clouds, uint64_t seed, FILE *log) {
+	std::mt19937_64 rng(seed);
+	std::uniform_real_distribution<double> unit(-1.0, 1.0);
+	/* The plane z = 0, and a tilted one. Whole-number points and axes put every point exactly
+	 * in the plane, as rounding would otherwise leave in-plane queries either side of it. */
+	const struct point3d origins[] = { { 0, 0, 0 }, { 100, -50, 25 } };
+	const struct vector3d us[] = { { 1, 0, 0 }, { 1, 0, 1 } };
+	const struct vector3d vs[] = { { 0, 1, 0 }, { 0, 1, 0 } };
+
+	int failures = 0;
+	for (int c = 0; c < clouds; c++) {
+		int plane = c % 2;
+		auto embed = [&](struct point q) {
+			struct point3d p = { origins[plane].x + q.x * us[plane].x + q.y * vs[plane].x,
+				origins[plane].y + q.x * us[plane].y + q.y * vs[plane].y, origins[plane].z + q.x * us[plane].z + q.y * vs[plane].z };
+			return p;
+		};
+
+		std::vector<struct point> flat = generatePointSet(UNIFORM_SET, 3 + rng() % 40, rng());
+		std::vector<struct point3d> cloud;
+		for (int i = 0; i < flat.size(); i++) {
+			flat[i] = { round(flat[i].x), round(flat[i].y) };
+			cloud.push_back(embed(flat[i]));
+		}
+		std::vector<struct point> expected = referenceHull(flat);
+		if (expected.size() < 3)
+			continue;
+
+		ConvexHull3D hull(cloud);
+		double tolerance = 1e-9 * largestCoordinate(flat);
+		for (int k = 0; k < 50; k++) {
+			struct point q = { round(unit(rng) * 1500), round(unit(rng) * 1500) };
+			// Too close to an edge to call either way
+			if (referenceContains(&expected, q, tolerance) != referenceContains(&expected, q, 0))
+				continue;
+			struct point3d p = embed(q);
+			if (hull.containsPoint(p) != referenceContains(&expected, q, 0)) {
+				failures += report(log, "ConvexHull3D::containsPoint in the plane of a flat hull", &flat, &expected, NULL);
+				break;
+			}
+			// Off the plane is outside, however far inside the polygon
+			struct vector3d normal = crossProduct3d(us[plane], vs[plane]);
+			if (hull.containsPoint({ p.x + normal.x, p.y + normal.y, p.z + normal.z })) {
+				failures += report(log, "ConvexHull3D::containsPoint off the plane of a flat hull", &flat, &expected, NULL);
+				break;
+			}
+		}
+	}
+	return failures;
+}
+
+struct verifyStats runSoak(double seconds, uint64_t seed, double reportInterval, FILE *log) {
+	struct verifyStats stats = { 0, 0, 0, 0 };
+	std::mt19937_64 rng(seed);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	double lastReport = 0;
+	long long lastCases = 0;
+
+	stats.failures += verifyDegenerateRegions(log);
+	stats.failures += verifyCollisionWorld(1000, 8, rng(), log);
+	stats.failures += verifyFlatHulls3D(500, rng(), log);
+
+	while (stats.seconds < seconds) {
+		enum PointSetKind kind = (enum PointSetKind)(rng() % POINT_SET_KIND_COUNT);
+		std::vector<struct point> set1 = generatePointSet(kind, 1 + rng() % 40, rng());
+		std::vector<struct point> set2 = generatePointSet(kind, 1 + rng() % 40, rng());
+
+		int baseline = 0;
+		stats.failures += verifyPointSets(set1, set2, log, &baseline);
+		stats.baselineFailures += baseline;
+		stats.cases++;
+		stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (log && stats.seconds - lastReport >= reportInterval) {
+			fprintf(log, "%lld cases, %lld failures, %lld baseline failures, %.0f cases/s\n", stats.cases, stats.failures,
+				stats.baselineFailures, (stats.cases - lastCases) / (stats.seconds - lastReport));
+			lastReport = stats.seconds;
+			lastCases = stats.cases;
+		}
+	}
+
+	if (log)
+		fprintf(log, "Soak finished: %lld cases, %lld failures, %lld baseline failures, %.0f cases/s\n", stats.cases, stats.failures,
+			stats.baselineFailures, stats.seconds > 0 ? stats.cases / stats.seconds : 0);
+
+	return stats;
+}
+
+#ifdef HULL_FUZZER
+/* libFuzzer entry point: clang++ -fsanitize=fuzzer -DHULL_FUZZER ...
+ * The first byte picks a coordinate scale, the rest is read as pairs of 16-bit coordinates
+ * which are split evenly between the two point sets. */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+	if (size < 1 + 8)
+		return 0;
+
+	double scale = pow(10.0, data[0] % 13);
+	std::vector<struct point> points;
+	for (size_t i = 1; i + 4 <= size; i += 4) {
+		int16_t x = (int16_t)(data[i] | (data[i + 1] << 8));
+		int16_t y = (int16_t)(data[i + 2] | (data[i + 3] << 8));
+		points.push_back({ x * scale, y * scale });
+	}
+
+	std::vector<struct point> set1(points.begin(), points.begin() + (points.size() + 1) / 2);
+	std::vector<struct point> set2(points.begin() + (points.size() + 1) / 2, points.end());
+	if (set2.empty())
+		set2 = set1;
+
+	/* The original code's known disagreements are counted apart and don't stop the run, so the
+	 * fuzzer gets past them to the newer engines. A real failure is run again to describe it. */
+	int baseline = 0;
+	if (verifyPointSets(set1, set2, NULL, &baseline) != 0) {
+		verifyPointSets(set1, set2, stderr, &baseline);
+		abort();
+	}
+	return 0;
+}
+#endif
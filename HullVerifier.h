@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include "DataTypes.h"
+
+/* Differential testing of the hull code.
+ * Every engine registered in hullEngines is run on generated point sets and its output is
+ * compared vertex-for-vertex with a simple reference hull (Andrew's monotone chain).
+ * The Minkowski sum/difference paths, the GJK origin test and containsPoint are checked
+ * against brute-force oracles computed from the same reference, and the reference hull is put
+ * through the hull codec and back.
+ */
+
+typedef std::vector<struct point> (*HullEngineFunction)(std::vector<struct point> &points);
+
+struct hullEngine {
+	const char *name;
+	HullEngineFunction build;
+	bool baseline;		// the original code, whose failures are counted apart
+};
+
+extern const struct hullEngine hullEngines[];
+extern const int hullEngineCount;
+
+/* The kinds of adversarial input the generator produces */
+enum PointSetKind {
+	UNIFORM_SET,
+	DUPLICATE_SET,		// few distinct points repeated many times
+	COLLINEAR_SET,		// points on a handful of lines, including hull edges
+	HUGE_SET,			// coordinates around 1e12
+	SCREEN_GRID_SET,	// whole screen coordinates from the same workload as the GUI modes
+	POINT_SET_KIND_COUNT
+};
+
+struct verifyStats {
+	long long cases;
+	long long failures;
+	long long baselineFailures;
+	double seconds;
+};
+
+std::vector<struct point> referenceHull(std::vector<struct point> points);
+bool referenceContains(std::vector<struct point> *hull, struct point p, double tolerance);
+
+/* Removes repeated and collinear vertices and rotates the hull to start at its lowest,
+ * leftmost vertex in counter-clockwise order, so hulls from different engines compare equal */
+std::vector<struct point> canonicalHull(std::vector<struct point> hull, double tolerance);
+bool sameHull(std::vector<struct point> a, std::vector<struct point> b, double tolerance);
+
+std::vector<struct point> generatePointSet(enum PointSetKind kind, int count, uint64_t seed);
+
+/* Runs every check on one point set pair. Failures are described on log (if not NULL).
+ * Returns the number of failed checks on the newer code. The checks on the original getHull,
+ * containsPoint and Minkowski code, which disagree with the oracles on known inputs, are added
+ * to baselineFailures instead (if not NULL). */
+int verifyPointSets(std::vector<struct point> &set1, std::vector<struct point> &set2, FILE *log, int *baselineFailures = NULL);
+
+/* Checks half-plane intersections with no area, a point and segments along and across the
+ * axes, against their known extreme points, and a unit square under the default bound, which
+ * must keep its area. Returns the number of failed checks. */
+int verifyDegenerateRegions(FILE *log);
+
+/* Steps a world of randomly placed hulls on threads and on one thread, from the same fresh hulls,
+ * and checks both find the same pairs. Run under a thread sanitizer it also checks that the
+ * threads only read the hulls. Returns the number of failed checks. */
+int verifyCollisionWorld(int bodies, int threads, uint64_t seed, FILE *log);
+
+/* Checks ConvexHull3D::containsPoint on point clouds lying in a plane, both in the plane, against
+ * the polygon's reference hull, and just off it. Returns the number of failed checks. */
+int verifyFlatHulls3D(int clouds, uint64_t seed, FILE *log);
+
+/* Runs generated cases until the time runs out, printing throughput in cases per second
+ * every reportInterval seconds. ConvexHullAlgorithms.exe /soak [seconds] [seed] runs it. */
+struct verifyStats runSoak(double seconds, uint64_t seed, double reportInterval, FILE *log);
@@ -0,0 +1,142 @@
+#include "HullWorker.h"
+#include "ConvexHull.h"
+#include "HullProfiler.h"
+
+static const int FRESH_RESULT = 4;
+
+static bool samePoints(const std::vector<struct point> &a, const std::vector<struct point> &b) {
+	if (a.size() != b.size())
+		return false;
+
+	for (int i = 0; i < a.size(); i++) {
+		if (a[i].x != b[i].x || a[i].y != b[i].y)
+			return false;
+	}
+
+	return true;
+}
+
+bool sameHullJob(const struct hullJob &a, const struct hullJob &b) {
+	return a.kind == b.kind && a.scenario == b.scenario && a.origin.x == b.origin.x && a.origin.y == b.origin.y &&
+		samePoints(a.set1, b.set1) && samePoints(a.set2, b.set2);
+}
+
+HullWorker::HullWorker(std::function<void()> onResult) {
+	this->onResult = onResult;
+	this->pendingGeneration = 0;
+	this->stopping = false;
+	this->latestGeneration = 0;
+	for (int i = 0; i < 3; i++)
+		slots[i].generation = 0;
+	this->front = 0;
+	this->ready = 1;
+	this->back = 2;
+	this->thread = std::thread(&HullWorker::run, this);
+}
+
+HullWorker::~HullWorker() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+		latestGeneration++;
+	}
+	wake.notify_one();
+	thread.join();
+}
+
+unsigned long long HullWorker::submit(const struct hullJob &job) {
+	unsigned long long generation;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		pending = job;
+		generation = ++latestGeneration;
+		pendingGeneration = generation;
+	}
+	wake.notify_one();
+	return generation;
+}
+
+/* Returns the newest completed result, or NULL if nothing has completed yet.
+ * The result stays valid until the next call. */
+const struct hullResult *HullWorker::latest() {
+	if (ready.load(std::memory_order_acquire) & FRESH_RESULT)
+		front = ready.exchange(front, std::memory_order_acq_rel) & ~FRESH_RESULT;
+
+	return slots[front].generation ? &slots[front] : NULL;
+}
+
+void HullWorker::run() {
+	while (true) {
+		struct hullJob job;
+		unsigned long long generation;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			wake.wait(guard, [this] { return stopping || pendingGeneration != 0; });
+			if (stopping)
+				return;
+			job = pending;
+			generation = pendingGeneration;
+			pendingGeneration = 0;
+		}
+
+		if (!compute(job, &slots[back], &latestGeneration, generation, &gjkCache))
+			continue;
+
+		slots[back].generation = generation;
+		back = ready.exchange(back | FRESH_RESULT, std::memory_order_acq_rel) & ~FRESH_RESULT;
+
+		if (onResult)
+			onResult();
+	}
+}
+
+bool HullWorker::compute(const struct hullJob &job, struct hullResult *result, std::atomic<unsigned long long> *latestGeneration, unsigned long long generation, GJKCache *cache) {
+	HULL_PROFILE_SCOPE("HullWorker::compute");
+	result->scenario = job.scenario;
+	result->hull2.clear();
+	result->combined.clear();
+	result->containsPoint = false;
+	result->gjkStats = cache ? cache->stats() : gjkCacheStats{ 0, 0, 0 };
+
+	/* A newer job makes this one pointless, so the hulls and the Minkowski sum check for one
+	 * as they go and give up partway through */
+	std::function<bool()> cancelled;
+	if (latestGeneration)
+		cancelled = [latestGeneration, generation] { return *latestGeneration != generation; };
+
+	ConvexHull hull1(job.set1);
+	hull1.setCancel(cancelled);
+	if (hull1.getHull() == NULL)
+		return false;
+	result->hull1 = *hull1.getHull();
+
+	if (job.kind == HULL_CONTAINS_JOB && job.set2.size() > 0)
+		result->containsPoint = hull1.containsPoint(job.set2[0]);
+
+	if (job.kind != MINKOWSKI_SUM_JOB && job.kind != MINKOWSKI_DIFFERENCE_JOB)
+		return true;
+
+	ConvexHull hull2(job.set2);
+	hull2.setCancel(cancelled);
+	if (hull2.getHull() == NULL)
+		return false;
+	result->hull2 = *hull2.getHull();
+
+	Converter conv = job.conv;
+	ConvexHull *combined = job.kind == MINKOWSKI_SUM_JOB ? hull1.minkowskiSum(&hull1, &hull2, &conv) : hull1.minkowskiDifference(&hull1, &hull2, &conv);
+	if (combined == NULL)
+		return false;
+	result->combined = *combined->getHull();
+	delete combined;
+
+	/* The difference contains origin exactly when the hulls intersect, which GJK answers from
+	 * the hulls themselves. Consecutive drag frames query the same pair, hence the cache. */
+	if (job.kind == MINKOWSKI_DIFFERENCE_JOB) {
+		struct gjkResult gjk;
+		result->containsPoint = cache ? cache->query(0, 1, &hull1, &hull2, &gjk) : gjkIntersect(&hull1, &hull2);
+		if (cache)
+			result->gjkStats = cache->stats();
+	}
+
+	return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "DataTypes.h"
+#include "Converter.h"
+#include "GJKCache.h"
+
+/* Computes hulls off the UI thread.
+ * The UI submits a snapshot of its point sets; only the newest submission is kept, and a job
+ * that is already running gives up partway through whichever hull or Minkowski sum it is
+ * building once a newer one arrives.
+ * Completed results are handed back through three slots swapped with an atomic exchange
+ * (the back slot is owned by the worker, the front slot by the reader), so neither side
+ * ever blocks on the other.
+ */
+
+enum HullJobKind {
+	HULL_JOB,					// hull of set1
+	HULL_CONTAINS_JOB,			// hull of set1 and whether it contains set2[0]
+	MINKOWSKI_SUM_JOB,			// hulls of set1 and set2 and their Minkowski sum
+	MINKOWSKI_DIFFERENCE_JOB	// hulls of set1 and set2, their Minkowski difference and whether they intersect
+};
+
+struct hullJob {
+	enum HullJobKind kind;
+	int scenario;
+	std::vector<struct point> set1;
+	std::vector<struct point> set2;
+	Converter conv = Converter(0, 0);
+	struct point origin;
+};
+
+struct hullResult {
+	unsigned long long generation;	// 0 until the slot holds a result
+	int scenario;
+	std::vector<struct point> hull1;
+	std::vector<struct point> hull2;
+	std::vector<struct point> combined;
+	bool containsPoint;
+	struct gjkCacheStats gjkStats;	// of the worker's cache, zero for results computed without one
+};
+
+bool sameHullJob(const struct hullJob &a, const struct hullJob &b);
+
+class HullWorker
+{
+private:
+	std::thread thread;
+	std::mutex lock;
+	std::condition_variable wake;
+	struct hullJob pending;
+	unsigned long long pendingGeneration;
+	bool stopping;
+	std::atomic<unsigned long long> latestGeneration;
+
+	struct hullResult slots[3];
+	std::atomic<int> ready;	// index of the slot in the middle, with FRESH_RESULT set if the reader hasn't taken it
+	int back;
+	int front;
+	std::function<void()> onResult;
+	GJKCache gjkCache;		// only touched by the worker thread
+
+	void run();
+public:
+	HullWorker(std::function<void()> onResult);
+	~HullWorker();
+
+	unsigned long long submit(const struct hullJob &job);
+	const struct hullResult *latest();
+
+	/* Does the actual work of a job. Returns false if latestGeneration moved past generation
+	 * before it finished; pass NULL to run it to completion. The GJK test of a difference job
+	 * is warm-started from cache if one is given. */
+	static bool compute(const struct hullJob &job, struct hullResult *result, std::atomic<unsigned long long> *latestGeneration, unsigned long long generation, GJKCache *cache = NULL);
+};
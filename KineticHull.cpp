@@ -0,0 +1,457 @@
+#include "KineticHull.h"
+#include <math.h>
+#include <algorithm>
+
+#define FULL_TURN 6.283185307179586
+
+KineticHull::KineticHull(std::vector<struct point> positions, std::vector<struct vector> velocities) {
+	start = positions;
+	velocity = velocities;
+	velocity.resize(start.size(), { 0, 0 });
+	now = 0;
+	counts = { 0, 0, 0 };
+
+	int n = start.size();
+	next.assign(n, -1);
+	prev.assign(n, -1);
+	onHull.assign(n, false);
+	triangle.assign(n, std::vector<int>());
+	owner.assign(n, -1);
+	slot.assign(n, -1);
+	version.assign(n, 0);
+	rebuild();
+}
+
+struct point KineticHull::position(int i, double t) {
+	return { start[i].x + velocity[i].x * t, start[i].y + velocity[i].y * t };
+}
+
+/* Rotates a, b, c so they are always evaluated in the same order, which keeps the sign flipping
+ * exactly when two of them are swapped after rounding. Returns -1 if the order was reversed. */
+static double canonicalOrder(int *a, int *b, int *c) {
+	while (*a > *b || *a > *c) {
+		int first = *a;
+		*a = *b;
+		*b = *c;
+		*c = first;
+	}
+	if (*b > *c) {
+		std::swap(*b, *c);
+		return -1;
+	}
+	return 1;
+}
+
+double KineticHull::orientationNow(int a, int b, int c) {
+	double sign = canonicalOrder(&a, &b, &c);
+	struct point pa = position(a, now), pb = position(b, now), pc = position(c, now);
+	return sign * ((pb.x - pa.x) * (pc.y - pa.y) - (pb.y - pa.y) * (pc.x - pa.x));
+}
+
+/* The orientation of a, b, c as A t^2 + B t + C: with b - a = d1 + e1 t and c - a = d2 + e2 t,
+ * A = e1 x e2, B = d1 x e2 + e1 x d2 and C = d1 x d2 */
+void KineticHull::coefficients(int a, int b, int c, double *A, double *B, double *C) {
+	double sign = canonicalOrder(&a, &b, &c);
+	struct vector d1 = { start[b].x - start[a].x, start[b].y - start[a].y };
+	struct vector e1 = { velocity[b].x - velocity[a].x, velocity[b].y - velocity[a].y };
+	struct vector d2 = { start[c].x - start[a].x, start[c].y - start[a].y };
+	struct vector e2 = { velocity[c].x - velocity[a].x, velocity[c].y - velocity[a].y };
+
+	*A = sign * (e1.x * e2.y - e1.y * e2.x);
+	*B = sign * (d1.x * e2.y - d1.y * e2.x + e1.x * d2.y - e1.y * d2.x);
+	*C = sign * (d1.x * d2.y - d1.y * d2.x);
+}
+
+/* The sign of the orientation just after now. Collinear points are told apart by where they are
+ * heading, so a point on a hull edge that is moving out is already counted as a vertex.
+ * The value itself comes from the positions, so it agrees exactly with rebuild's sort on ties. */
+int KineticHull::turnAfterNow(int a, int b, int c) {
+	double A, B, C;
+	coefficients(a, b, c, &A, &B, &C);
+	double sign = orientationNow(a, b, c);
+	if (sign == 0)
+		sign = 2 * A * now + B;
+	if (sign == 0)
+		sign = A;
+	return (sign > 0) - (sign < 0);
+}
+
+/* The first time from now on at which the orientation of a, b, c turns negative. Only roots
+ * where it is decreasing count; at the others it is just coming back from zero, e.g. right
+ * after the event that caused it. */
+double KineticHull::failureTime(int a, int b, int c) {
+	double A, B, C;
+	coefficients(a, b, c, &A, &B, &C);
+	double valueNow = (A * now + B) * now + C;
+	double slopeNow = 2 * A * now + B;
+	if ((valueNow < 0 && slopeNow <= 0) || (valueNow == 0 && (slopeNow < 0 || (slopeNow == 0 && A < 0))))
+		return now;
+
+	// Clearly negative even if turning back: the structure is already wrong here and is fixed now
+	struct point pa = position(a, now), pb = position(b, now), pc = position(c, now);
+	double scale = hypot(pb.x - pa.x, pb.y - pa.y) * hypot(pc.x - pa.x, pc.y - pa.y);
+	if (valueNow < -1e-9 * scale)
+		return now;
+
+	double roots[2];
+	int count = 0;
+	if (A == 0) {
+		if (B != 0)
+			roots[count++] = -C / B;
+	}
+	else {
+		double discriminant = B * B - 4 * A * C;
+		if (discriminant > 0) {
+			// The numerically stable pair of roots
+			double q = -(B + (B < 0 ? -sqrt(discriminant) : sqrt(discriminant))) / 2;
+			roots[count++] = q / A;
+			if (q != 0)
+				roots[count++] = C / q;
+		}
+	}
+
+	// A root that rounding put just before now is a failure happening now
+	double first = INFINITY;
+	double earliest = now - 1e-12 * (1 + fabs(now));
+	for (int r = 0; r < count; r++) {
+		if (roots[r] >= earliest && 2 * A * roots[r] + B < 0)
+			first = std::min(first, std::max(roots[r], now));
+	}
+	return first;
+}
+
+/* Replaces whatever events point i had with its current certificates */
+void KineticHull::schedule(int i) {
+	version[i]++;
+	struct event e = { INFINITY, i, CONVEX, version[i] };
+
+	if (onHull[i]) {
+		// A vertex that stays on the line through its neighbours never fails, but isn't a vertex
+		double A, B, C;
+		coefficients(prev[i], i, next[i], &A, &B, &C);
+		e.time = A == 0 && B == 0 && C == 0 ? now : failureTime(prev[i], i, next[i]);
+	}
+	else if (owner[i] != -1) {
+		int a = owner[i], b = next[a];
+		double times[3] = { failureTime(apex, a, i), failureTime(a, b, i), failureTime(b, apex, i) };
+		enum certificate kinds[3] = { APEX_SIDE, HULL_EDGE, FAR_SIDE };
+		for (int k = 0; k < 3; k++) {
+			if (times[k] < e.time) {
+				e.time = times[k];
+				e.kind = kinds[k];
+			}
+		}
+	}
+
+	if (e.time != INFINITY)
+		events.push(e);
+}
+
+void KineticHull::addToTriangle(int i, int e) {
+	owner[i] = e;
+	slot[i] = triangle[e].size();
+	triangle[e].push_back(i);
+}
+
+void KineticHull::removeFromTriangle(int i) {
+	std::vector<int> &list = triangle[owner[i]];
+	int last = list.back();
+	list[slot[i]] = last;
+	slot[last] = slot[i];
+	list.pop_back();
+	owner[i] = -1;
+	slot[i] = -1;
+}
+
+/* Puts interior point i into the right fan triangle, walking from triangle e */
+void KineticHull::relocate(int i, int e) {
+	if (e == apex)
+		e = next[apex];
+	if (next[e] == apex)
+		e = prev[e];
+
+	for (int steps = 0; steps < hullSize; steps++) {
+		if (prev[e] != apex && turnAfterNow(apex, e, i) < 0)
+			e = prev[e];
+		else if (next[next[e]] != apex && turnAfterNow(next[e], apex, i) < 0)
+			e = next[e];
+		else
+			break;
+	}
+
+	addToTriangle(i, e);
+	schedule(i);
+}
+
+/* Point i has reached the hull edge from after to next[after] */
+void KineticHull::insertIntoHull(int i, int after) {
+	int before = next[after];
+	removeFromTriangle(i);
+	next[after] = i;
+	prev[i] = after;
+	next[i] = before;
+	prev[before] = i;
+	onHull[i] = true;
+	hullSize++;
+	counts.hullChanges++;
+
+	// The triangle on that edge is split in two by the diagonal to i
+	if (after != apex && before != apex) {
+		std::vector<int> members;
+		members.swap(triangle[after]);
+		for (int k = 0; k < members.size(); k++) {
+			owner[members[k]] = -1;
+			relocate(members[k], after);
+		}
+	}
+
+	schedule(after);
+	schedule(i);
+	schedule(before);
+}
+
+/* Vertex v has stopped turning left and drops inside the hull */
+void KineticHull::removeFromHull(int v) {
+	int before = prev[v], after = next[v];
+	if (v == apex || hullSize <= 3) {
+		rebuild();
+		return;
+	}
+
+	// The triangles on both sides of v merge; their points and v itself are placed again
+	std::vector<int> members;
+	if (before != apex)
+		members.insert(members.end(), triangle[before].begin(), triangle[before].end());
+	if (after != apex)
+		members.insert(members.end(), triangle[v].begin(), triangle[v].end());
+	triangle[before].clear();
+	triangle[v].clear();
+
+	next[before] = after;
+	prev[after] = before;
+	onHull[v] = false;
+	next[v] = prev[v] = -1;
+	hullSize--;
+	counts.hullChanges++;
+
+	members.push_back(v);
+	for (int k = 0; k < members.size(); k++) {
+		owner[members[k]] = -1;
+		relocate(members[k], before != apex ? before : after);
+	}
+
+	schedule(before);
+	schedule(after);
+}
+
+/* Builds the hull and the fan from scratch at the current time (monotone chain) */
+void KineticHull::rebuild() {
+	int n = start.size();
+	counts.rebuilds++;
+	events = std::priority_queue<struct event, std::vector<struct event>, std::greater<struct event>>();
+	for (int i = 0; i < n; i++) {
+		version[i]++;
+		onHull[i] = false;
+		owner[i] = slot[i] = next[i] = prev[i] = -1;
+		triangle[i].clear();
+	}
+
+	std::vector<struct point> at(n);
+	std::vector<int> order(n);
+	for (int i = 0; i < n; i++) {
+		at[i] = position(i, now);
+		order[i] = i;
+	}
+	// Sorted by where the points are just after now, to agree with turnAfterNow
+	std::sort(order.begin(), order.end(), [&](int a, int b) {
+		if (at[a].x != at[b].x)
+			return at[a].x < at[b].x;
+		if (velocity[a].x != velocity[b].x)
+			return velocity[a].x < velocity[b].x;
+		if (at[a].y != at[b].y)
+			return at[a].y < at[b].y;
+		return velocity[a].y < velocity[b].y;
+	});
+
+	std::vector<int> chain(2 * n + 1);
+	int k = 0;
+	for (int i = 0; i < n; i++) {
+		while (k >= 2 && turnAfterNow(chain[k - 2], chain[k - 1], order[i]) <= 0)
+			k--;
+		chain[k++] = order[i];
+	}
+	for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+		while (k >= lower && turnAfterNow(chain[k - 2], chain[k - 1], order[i]) <= 0)
+			k--;
+		chain[k++] = order[i];
+	}
+	chain.resize(std::max(0, k - 1));
+
+	/* Rounding can keep a vertex whose certificate fails right now, which would only bring the
+	 * same rebuild straight back, so those are left inside */
+	for (bool pruned = true; pruned && chain.size() >= 3;) {
+		pruned = false;
+		for (int i = 0; i < chain.size() && chain.size() >= 3; i++) {
+			int h = chain.size();
+			if (failureTime(chain[(i + h - 1) % h], chain[i], chain[(i + 1) % h]) <= now) {
+				chain.erase(chain.begin() + i);
+				pruned = true;
+			}
+		}
+	}
+
+	hullSize = chain.size();
+	apex = hullSize > 0 ? chain[0] : -1;
+	for (int i = 0; i < hullSize; i++) {
+		next[chain[i]] = chain[(i + 1) % hullSize];
+		prev[chain[i]] = chain[(i + hullSize - 1) % hullSize];
+		onHull[chain[i]] = true;
+	}
+	if (hullSize < 3)
+		return;
+
+	// The fan triangles are in angular order around the apex, so each point is found by bisection
+	for (int i = 0; i < n; i++) {
+		if (onHull[i])
+			continue;
+
+		int low = 1, high = hullSize - 2;
+		while (low < high) {
+			int middle = (low + high + 1) / 2;
+			if (turnAfterNow(apex, chain[middle], i) >= 0)
+				low = middle;
+			else
+				high = middle - 1;
+		}
+		addToTriangle(i, chain[low]);
+	}
+
+	for (int i = 0; i < n; i++)
+		schedule(i);
+}
+
+void KineticHull::handle(const struct event &e) {
+	int i = e.point;
+
+	if (e.kind == CONVEX) {
+		removeFromHull(i);
+		return;
+	}
+
+	// A point crossing a diagonal moves to the next triangle, unless that side is a hull edge
+	int a = owner[i], b = next[a];
+	if (e.kind == HULL_EDGE) {
+		insertIntoHull(i, a);
+	}
+	else if (e.kind == APEX_SIDE) {
+		if (prev[a] == apex)
+			insertIntoHull(i, apex);
+		else {
+			removeFromTriangle(i);
+			addToTriangle(i, prev[a]);
+			schedule(i);
+		}
+	}
+	else {
+		if (next[b] == apex)
+			insertIntoHull(i, b);
+		else {
+			removeFromTriangle(i);
+			addToTriangle(i, b);
+			schedule(i);
+		}
+	}
+}
+
+void KineticHull::advance(double time) {
+	/* In degenerate positions events can keep firing at one instant without getting anywhere.
+	 * Then the hull is simply rebuilt at the target time. */
+	int sameInstant = 0;
+	double lastTime = now;
+
+	while (!events.empty() && events.top().time <= time) {
+		struct event e = events.top();
+		events.pop();
+		if (e.version != version[e.point])
+			continue;
+
+		sameInstant = e.time == lastTime ? sameInstant + 1 : 0;
+		lastTime = e.time;
+		if (sameInstant > 4 * (int)start.size() + 16) {
+			now = std::max(now, time);
+			rebuild();
+			return;
+		}
+
+		now = std::max(now, e.time);
+		counts.events++;
+		handle(e);
+	}
+
+	now = std::max(now, time);
+	// Fewer than three points off a line can't be certified, so those are just looked at again
+	if (hullSize < 3 || !windsOnce())
+		rebuild();
+}
+
+/* The certificates only prove the hull locally convex. When several points meet at one instant
+ * (grid-like input) it can come out of the events winding around twice, so the total turn is
+ * checked too; that is O(h), next to the O(n log n) rebuild it triggers. */
+bool KineticHull::windsOnce() {
+	std::vector<struct vector> edges;
+	int v = apex;
+	do {
+		struct point p = position(v, now), q = position(next[v], now);
+		if (p.x != q.x || p.y != q.y)
+			edges.push_back({ q.x - p.x, q.y - p.y });
+		v = next[v];
+	} while (v != apex);
+
+	double turn = 0;
+	for (int k = 0; k < edges.size(); k++) {
+		struct vector a = edges[k], b = edges[(k + 1) % edges.size()];
+		turn += atan2(a.x * b.y - a.y * b.x, a.x * b.x + a.y * b.y);
+	}
+	return fabs(turn - FULL_TURN) < 1e-6;
+}
+
+void KineticHull::setVelocity(int index, struct vector v) {
+	struct point p = position(index, now);
+	velocity[index] = v;
+	start[index] = { p.x - v.x * now, p.y - v.y * now };
+
+	// The point may be in any number of other points' certificates, so everything is rescheduled
+	events = std::priority_queue<struct event, std::vector<struct event>, std::greater<struct event>>();
+	if (hullSize < 3)
+		return;
+	for (int i = 0; i < start.size(); i++)
+		schedule(i);
+}
+
+std::vector<int> KineticHull::hullIndices() {
+	std::vector<int> indices;
+	if (hullSize == 0)
+		return indices;
+
+	int first = apex;
+	for (int v = next[apex], k = 0; k < hullSize; v = next[v], k++) {
+		struct point p = position(v, now), best = position(first, now);
+		if (p.y < best.y || (p.y == best.y && p.x < best.x))
+			first = v;
+	}
+
+	int v = first;
+	do {
+		indices.push_back(v);
+		v = next[v];
+	} while (v != first);
+	return indices;
+}
+
+std::vector<struct point> KineticHull::hull() {
+	std::vector<int> indices = hullIndices();
+	std::vector<struct point> points;
+	for (int k = 0; k < indices.size(); k++)
+		points.push_back(position(indices[k], now));
+	return points;
+}
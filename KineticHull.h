@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include "DataTypes.h"
+
+/* Convex hull of points moving along straight lines, kept valid as time advances without
+ * rebuilding it.
+ * The hull is proved by certificates, each an orientation of three moving points that must stay
+ * positive:
+ *  - every hull vertex turns left from its predecessor to its successor;
+ *  - every other point is inside one triangle of a fan from one hull vertex, the apex, to the
+ *    hull edges, i.e. on the inner side of the hull edge and of the two fan diagonals.
+ * An orientation of linearly moving points is quadratic in time, so each certificate knows when
+ * it will fail. Those times go into a priority queue, and advance() only does work at them: a
+ * point crossing a diagonal moves to the neighbouring triangle, a point crossing a hull edge is
+ * inserted into the hull, and a vertex that stops turning left is dropped from it. Each such
+ * event touches one or two triangles. If the apex itself leaves the hull, the fan is rebuilt,
+ * as it is when degenerate motion (many points meeting at one instant) leaves the hull in a
+ * state the certificates can't vouch for.
+ */
+
+struct kineticStats {
+	long long events;			// certificate failures processed
+	long long hullChanges;		// of those, the ones that changed the hull
+	long long rebuilds;
+};
+
+class KineticHull
+{
+private:
+	enum certificate { CONVEX, APEX_SIDE, HULL_EDGE, FAR_SIDE };
+
+	struct event {
+		double time;
+		int point;
+		enum certificate kind;
+		unsigned int version;
+		// Hull vertices go first among simultaneous events, so points are placed against the new hull
+		bool operator>(const struct event &other) const { return time > other.time || (time == other.time && kind > other.kind); }
+	};
+
+	std::vector<struct point> start;		// positions at time 0
+	std::vector<struct vector> velocity;
+	double now;
+
+	// The hull as a circular doubly linked list over point indices
+	std::vector<int> next, prev;
+	std::vector<bool> onHull;
+	int apex;
+	int hullSize;
+
+	/* Interior points by fan triangle: triangle[e] holds the points inside (apex, e, next[e]) */
+	std::vector<std::vector<int>> triangle;
+	std::vector<int> owner;					// hull vertex whose triangle holds each interior point
+	std::vector<int> slot;					// position in that triangle's list
+
+	std::vector<unsigned int> version;		// bumped whenever a point's events are rescheduled
+	std::priority_queue<struct event, std::vector<struct event>, std::greater<struct event>> events;
+	struct kineticStats counts;
+
+	struct point position(int i, double t);
+	double orientationNow(int a, int b, int c);
+	void coefficients(int a, int b, int c, double *A, double *B, double *C);
+	int turnAfterNow(int a, int b, int c);
+	double failureTime(int a, int b, int c);
+	void schedule(int i);
+	void addToTriangle(int i, int e);
+	void removeFromTriangle(int i);
+	void relocate(int i, int e);
+	void insertIntoHull(int i, int after);
+	void removeFromHull(int v);
+	void rebuild();
+	void handle(const struct event &e);
+	bool windsOnce();
+public:
+	/* Positions at time 0 and the distance each point moves per unit of time */
+	KineticHull(std::vector<struct point> positions, std::vector<struct vector> velocities);
+
+	/* Processes every event up to time; time can't go backwards */
+	void advance(double time);
+	/* Changes a point's velocity from the current time on, keeping its position continuous */
+	void setVelocity(int index, struct vector velocity);
+
+	double time() { return now; }
+	/* Counter-clockwise from the bottommost vertex at the current time, like getHull */
+	std::vector<struct point> hull();
+	std::vector<int> hullIndices();
+	struct kineticStats stats() { return counts; }
+};
@@ -0,0 +1,150 @@
+#include "PointGenerator.h"
+#include <math.h>
+#include <thread>
+#include <algorithm>
+
+// Fewer points than this per thread aren't worth starting a thread for
+#define MIN_POINTS_PER_THREAD 65536
+// Random words set aside for each point, whether or not its distribution uses them all
+#define WORDS_PER_POINT 4
+#define MAX_CLUSTERS 64
+#define DEGENERATE_ANCHORS 4
+
+#define GOLDEN_GAMMA 0x9E3779B97F4A7C15ull
+#define STRUCTURE_STREAM 0xD1B54A32D192ED03ull
+#define TWO_PI 6.283185307179586
+
+/* SplitMix64's finalizer, which spreads every bit of its input over the whole output */
+static inline uint64_t mix(uint64_t z) {
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+static inline uint64_t randomWord(uint64_t key, uint64_t counter) {
+	return mix(key + counter * GOLDEN_GAMMA);
+}
+
+/* The top 53 bits as a double in [0, 1) */
+static inline double unitInterval(uint64_t word) {
+	return (double)(word >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Picks one of n values with the top 32 bits, by multiplying rather than dividing */
+static inline int pick(uint64_t word, int n) {
+	return (int)(((word >> 32) * (uint64_t)n) >> 32);
+}
+
+struct pointWorkload makePointWorkload(enum PointDistribution distribution, uint64_t seed, struct point low, struct point high, bool integer) {
+	return { distribution, seed, low, high, 8, 0.05, integer };
+}
+
+/* Cluster centres and degenerate anchors, uniform over the box. They come from a stream of
+ * their own, so they are the same whichever range of points is being made. */
+static void structurePoints(const struct pointWorkload &workload, int count, struct point *out) {
+	uint64_t key = mix(workload.seed ^ STRUCTURE_STREAM);
+	double width = workload.high.x - workload.low.x, height = workload.high.y - workload.low.y;
+	for (int i = 0; i < count; i++) {
+		out[i].x = workload.low.x + width * unitInterval(randomWord(key, 2 * i));
+		out[i].y = workload.low.y + height * unitInterval(randomWord(key, 2 * i + 1));
+	}
+}
+
+void generatePoints(const struct pointWorkload &workload, uint64_t first, int count, struct point *out) {
+	uint64_t key = mix(workload.seed);
+	double width = workload.high.x - workload.low.x, height = workload.high.y - workload.low.y;
+	struct point center = { workload.low.x + width / 2, workload.low.y + height / 2 };
+
+	switch (workload.distribution) {
+	case UNIFORM_POINTS:
+		for (int i = 0; i < count; i++) {
+			uint64_t counter = (first + i) * WORDS_PER_POINT;
+			out[i].x = workload.low.x + width * unitInterval(randomWord(key, counter));
+			out[i].y = workload.low.y + height * unitInterval(randomWord(key, counter + 1));
+		}
+		break;
+
+	case DISK_POINTS:
+		for (int i = 0; i < count; i++) {
+			uint64_t counter = (first + i) * WORDS_PER_POINT;
+			double r = sqrt(unitInterval(randomWord(key, counter)));
+			double angle = TWO_PI * unitInterval(randomWord(key, counter + 1));
+			out[i].x = center.x + width / 2 * r * cos(angle);
+			out[i].y = center.y + height / 2 * r * sin(angle);
+		}
+		break;
+
+	case CIRCLE_POINTS:
+		for (int i = 0; i < count; i++) {
+			double angle = TWO_PI * unitInterval(randomWord(key, (first + i) * WORDS_PER_POINT));
+			out[i].x = center.x + width / 2 * cos(angle);
+			out[i].y = center.y + height / 2 * sin(angle);
+		}
+		break;
+
+	case CLUSTERED_POINTS: {
+		int clusters = std::max(1, std::min(workload.clusters, MAX_CLUSTERS));
+		struct point centers[MAX_CLUSTERS];
+		structurePoints(workload, clusters, centers);
+		double deviationX = width * workload.spread, deviationY = height * workload.spread;
+
+		// Box-Muller, one pair of normal deviates per point
+		for (int i = 0; i < count; i++) {
+			uint64_t counter = (first + i) * WORDS_PER_POINT;
+			struct point c = centers[pick(randomWord(key, counter), clusters)];
+			double r = sqrt(-2 * log(1 - unitInterval(randomWord(key, counter + 1))));
+			double angle = TWO_PI * unitInterval(randomWord(key, counter + 2));
+			out[i].x = c.x + deviationX * r * cos(angle);
+			out[i].y = c.y + deviationY * r * sin(angle);
+		}
+		break;
+	}
+
+	case DEGENERATE_POINTS: {
+		struct point anchors[DEGENERATE_ANCHORS];
+		structurePoints(workload, DEGENERATE_ANCHORS, anchors);
+
+		/* A point 0 to 31 32nds of the way from one anchor to another, or the first anchor itself
+		 * half the time, so there are many exact repeats and runs of collinear points */
+		for (int i = 0; i < count; i++) {
+			uint64_t counter = (first + i) * WORDS_PER_POINT;
+			uint64_t word = randomWord(key, counter);
+			struct point a = anchors[pick(word, DEGENERATE_ANCHORS)];
+			struct point b = anchors[word & (DEGENERATE_ANCHORS - 1)];
+			double t = (double)((word >> 8) & 31) / 32 * (double)((word >> 16) & 1);
+			out[i].x = a.x + (b.x - a.x) * t;
+			out[i].y = a.y + (b.y - a.y) * t;
+		}
+		break;
+	}
+
+	default:
+		for (int i = 0; i < count; i++)
+			out[i] = center;
+	}
+
+	if (workload.integer) {
+		for (int i = 0; i < count; i++) {
+			out[i].x = floor(out[i].x);
+			out[i].y = floor(out[i].y);
+		}
+	}
+}
+
+std::vector<struct point> generatePoints(const struct pointWorkload &workload, int count, int threads) {
+	std::vector<struct point> points(std::max(0, count));
+	if (threads <= 0)
+		threads = std::max(1, (int)std::thread::hardware_concurrency());
+	threads = std::max(1, std::min(threads, count / MIN_POINTS_PER_THREAD));
+
+	auto range = [&](int t) { return (int)((long long)count * t / threads); };
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; t++)
+		workers.push_back(std::thread([&, t]() { generatePoints(workload, range(t), range(t + 1) - range(t), points.data() + range(t)); }));
+	generatePoints(workload, 0, range(1), points.data());
+
+	for (int t = 0; t < workers.size(); t++)
+		workers[t].join();
+
+	return points;
+}
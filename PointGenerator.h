@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "DataTypes.h"
+
+/* Seeded point sets for the GUI, the verifier and benchmarks, so all of them can build exactly
+ * the same inputs.
+ * The generator is counter-based: every random word is a hash of the seed and the word's index,
+ * with no state carried from one point to the next. Point i of a workload is always the same
+ * whichever thread makes it and whatever range it is made in, so large sets are filled by
+ * several threads at once and a single point can be regenerated on its own. Each distribution
+ * has its own loop with no branches on the random words, which leaves the compiler free to
+ * unroll and vectorize it. Only integer arithmetic and IEEE operations are used on the words, so
+ * uniform points come out the same on every platform; the others also go through the standard
+ * library's sqrt, log, sin and cos.
+ */
+
+enum PointDistribution {
+	UNIFORM_POINTS,		// uniform over the box
+	DISK_POINTS,		// uniform over the ellipse inscribed in the box
+	CIRCLE_POINTS,		// on the ellipse inscribed in the box, all of them hull vertices
+	CLUSTERED_POINTS,	// Gaussian clusters around centres uniform over the box
+	DEGENERATE_POINTS,	// repeats of a few points and points on the lines between them
+	POINT_DISTRIBUTION_COUNT
+};
+
+struct pointWorkload {
+	enum PointDistribution distribution;
+	uint64_t seed;
+	struct point low;		// corners of the box the points are spread over
+	struct point high;
+	int clusters;			// CLUSTERED_POINTS only
+	double spread;			// standard deviation of a cluster, as a fraction of the box
+	bool integer;			// rounds down to whole numbers, like screen coordinates
+};
+
+/* A workload with the defaults for everything but the distribution, seed and box */
+struct pointWorkload makePointWorkload(enum PointDistribution distribution, uint64_t seed, struct point low, struct point high, bool integer = false);
+
+/* Writes points first to first + count - 1 of the workload to out */
+void generatePoints(const struct pointWorkload &workload, uint64_t first, int count, struct point *out);
+
+/* The first count points of the workload. threads is the most threads to use, 0 for one per
+ * core; the points don't depend on it. */
+std::vector<struct point> generatePoints(const struct pointWorkload &workload, int count, int threads = 1);
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vector>
+
+/* Keeps items in one contiguous vector so per-frame passes are a linear walk, while handing out
+ * handles that stay valid when other items are removed. Removing an item moves the last item
+ * into its place, so indices change on removal but handles never do.
+ */
+template <class T>
+class PointStore
+{
+private:
+	std::vector<T> items;
+	std::vector<int> handles;		// handle of the item at each index
+	std::vector<int> indices;		// index of the item for each handle, -1 once it is removed
+	std::vector<int> freeHandles;
+
+public:
+	static const int InvalidHandle = -1;
+
+	int add(const T &item) {
+		int handle;
+		if (freeHandles.size() > 0) {
+			handle = freeHandles.back();
+			freeHandles.pop_back();
+		}
+		else {
+			handle = indices.size();
+			indices.push_back(-1);
+		}
+
+		indices[handle] = items.size();
+		handles.push_back(handle);
+		items.push_back(item);
+		return handle;
+	}
+
+	void remove(int handle) {
+		if (!contains(handle))
+			return;
+
+		int index = indices[handle];
+		int last = items.size() - 1;
+		items[index] = items[last];
+		handles[index] = handles[last];
+		indices[handles[index]] = index;
+		items.pop_back();
+		handles.pop_back();
+
+		indices[handle] = -1;
+		freeHandles.push_back(handle);
+	}
+
+	void clear() {
+		items.clear();
+		handles.clear();
+		indices.clear();
+		freeHandles.clear();
+	}
+
+	bool contains(int handle) const {
+		return handle >= 0 && handle < indices.size() && indices[handle] != -1;
+	}
+
+	int indexOf(int handle) const { return contains(handle) ? indices[handle] : -1; }
+	int handleAt(int index) const { return handles[index]; }
+	T *get(int handle) { return contains(handle) ? &items[indices[handle]] : NULL; }
+
+	T &operator[](int index) { return items[index]; }
+	T &back() { return items.back(); }
+	int size() const { return items.size(); }
+
+	typename std::vector<T>::iterator begin() { return items.begin(); }
+	typename std::vector<T>::iterator end() { return items.end(); }
+};
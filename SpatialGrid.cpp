@@ -0,0 +1,79 @@
+#include "SpatialGrid.h"
+#include <math.h>
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(double cellSize) {
+	this->cellSize = cellSize;
+}
+
+int SpatialGrid::cellCoordinate(double v) {
+	return (int)floor(v / cellSize);
+}
+
+/* Built from unsigned values, since shifting a negative x left is undefined */
+long long SpatialGrid::cellKey(int x, int y) {
+	return (long long)(((unsigned long long)(unsigned int)x << 32) | (unsigned int)y);
+}
+
+void SpatialGrid::insertCells(int handle) {
+	struct cellRange r = entries[handle];
+	for (int x = r.minX; x <= r.maxX; x++) {
+		for (int y = r.minY; y <= r.maxY; y++)
+			cells[cellKey(x, y)].push_back(handle);
+	}
+}
+
+void SpatialGrid::removeCells(int handle) {
+	struct cellRange r = entries[handle];
+	for (int x = r.minX; x <= r.maxX; x++) {
+		for (int y = r.minY; y <= r.maxY; y++) {
+			auto cell = cells.find(cellKey(x, y));
+			if (cell == cells.end())
+				continue;
+
+			std::vector<int> &list = cell->second;
+			auto found = std::find(list.begin(), list.end(), handle);
+			if (found != list.end()) {
+				*found = list.back();
+				list.pop_back();
+			}
+			if (list.empty())
+				cells.erase(cell);
+		}
+	}
+}
+
+void SpatialGrid::update(int handle, struct point center, double radiusX, double radiusY) {
+	struct cellRange r = { cellCoordinate(center.x - radiusX), cellCoordinate(center.y - radiusY),
+		cellCoordinate(center.x + radiusX), cellCoordinate(center.y + radiusY), true };
+
+	if (handle >= entries.size())
+		entries.resize(handle + 1, { 0, 0, -1, -1, false });
+
+	struct cellRange old = entries[handle];
+	if (old.present && old.minX == r.minX && old.minY == r.minY && old.maxX == r.maxX && old.maxY == r.maxY)
+		return;
+
+	if (old.present)
+		removeCells(handle);
+	entries[handle] = r;
+	insertCells(handle);
+}
+
+void SpatialGrid::remove(int handle) {
+	if (handle < 0 || handle >= entries.size() || !entries[handle].present)
+		return;
+
+	removeCells(handle);
+	entries[handle].present = false;
+}
+
+void SpatialGrid::clear() {
+	cells.clear();
+	entries.clear();
+}
+
+const std::vector<int> *SpatialGrid::candidates(struct point p) {
+	auto cell = cells.find(cellKey(cellCoordinate(p.x), cellCoordinate(p.y)));
+	return cell == cells.end() ? NULL : &cell->second;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include "DataTypes.h"
+
+/* Uniform grid over the bounding boxes of handle-identified ellipses, for hit testing.
+ * Each entry is listed in every cell its bounding box touches, so a query only has to look
+ * at the one cell containing the query point. Moving an entry within the same cells is free.
+ */
+class SpatialGrid
+{
+private:
+	struct cellRange {
+		int minX, minY, maxX, maxY;
+		bool present;
+	};
+
+	double cellSize;
+	std::unordered_map<long long, std::vector<int>> cells;
+	std::vector<struct cellRange> entries;		// indexed by handle
+
+	int cellCoordinate(double v);
+	long long cellKey(int x, int y);
+	void insertCells(int handle);
+	void removeCells(int handle);
+public:
+	SpatialGrid(double cellSize);
+
+	/* Inserts the entry or moves it to its new bounds */
+	void update(int handle, struct point center, double radiusX, double radiusY);
+	void remove(int handle);
+	void clear();
+
+	/* Handles whose bounding boxes may contain p, or NULL if there are none */
+	const std::vector<int> *candidates(struct point p);
+};
@@ -0,0 +1,54 @@
+#include "TimeOfImpact.h"
+#include "GJK.h"
+#include <math.h>
+
+bool timeOfImpact(ConvexHull *a, struct vector motionA, ConvexHull *b, struct vector motionB, struct toiResult *result, double tolerance) {
+	// Everything is measured relative to A, which then stays put
+	struct vector motion = { motionB.x - motionA.x, motionB.y - motionA.y };
+	struct gjkSimplex simplex;
+	simplex.count = 0;
+
+	result->hit = false;
+	result->time = 0;
+	result->normal = { 0, 0 };
+	result->iterations = 0;
+
+	double t = 0;
+	bool separating = false;
+	while (result->iterations < TOI_MAX_ITERATIONS) {
+		result->iterations++;
+
+		struct gjkResult gjk;
+		gjkQuery(a, b, &simplex, &gjk, true, { motion.x * t, motion.y * t });
+		result->contactA = { gjk.closestA.x + motionA.x * t, gjk.closestA.y + motionA.y * t };
+		result->contactB = { gjk.closestB.x + motionA.x * t, gjk.closestB.y + motionA.y * t };
+		result->time = t;
+
+		if (gjk.distance <= tolerance) {
+			result->hit = true;
+			break;
+		}
+
+		result->normal = { (gjk.closestB.x - gjk.closestA.x) / gjk.distance, (gjk.closestB.y - gjk.closestA.y) / gjk.distance };
+
+		// How fast B approaches A along the normal; the gap can't close faster than this
+		double closingSpeed = -(motion.x * result->normal.x + motion.y * result->normal.y);
+		if (closingSpeed <= 0) {
+			separating = true;
+			break;
+		}
+
+		t += (gjk.distance - tolerance * 0.5) / closingSpeed;
+		if (t > 1) {
+			separating = true;
+			break;
+		}
+	}
+
+	// Out of iterations while still closing in, so stop at the last safe time rather than risk tunnelling
+	if (!separating)
+		result->hit = true;
+	if (!result->hit)
+		result->time = 1;
+	return result->hit;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "DataTypes.h"
+#include "ConvexHull.h"
+
+/* Time of impact of two hulls translating linearly, by conservative advancement.
+ * Each step measures the distance between the hulls with GJK at the current time and advances
+ * by distance / closing speed along the separating normal. Nothing can close the gap faster
+ * than that, so the time never overshoots the first contact and tunnelling is impossible.
+ * Each GJK query is warm-started from the previous one, since the hulls have only moved a little.
+ */
+
+#define TOI_MAX_ITERATIONS 32
+
+struct toiResult {
+	bool hit;
+	double time;				// fraction of the motion at first contact, 1 if there is none
+	struct vector normal;		// unit separating normal from A to B at that time
+	struct point contactA;		// closest points at that time, in world coordinates
+	struct point contactB;
+	int iterations;
+};
+
+/* The hulls move by motionA and motionB over the time from 0 to 1. Contact is reached once they
+ * are within tolerance of each other. Returns true if they touch at some time in [0, 1]; if
+ * TOI_MAX_ITERATIONS runs out first, the last time known to be safe is reported as a hit. */
+bool timeOfImpact(ConvexHull *a, struct vector motionA, ConvexHull *b, struct vector motionB, struct toiResult *result, double tolerance = 1e-6);
@@ -0,0 +1,112 @@
+#include "TransformedHull.h"
+#include <algorithm>
+
+static struct point apply(struct affineTransform t, struct point p) {
+	return { p.x * t.scale + t.offset.x, p.y * t.scale + t.offset.y };
+}
+
+static struct point invert(struct affineTransform t, struct point p) {
+	return { (p.x - t.offset.x) / t.scale, (p.y - t.offset.y) / t.scale };
+}
+
+TransformedHull::TransformedHull(std::vector<struct point> localPoints, enum HullAlgorithm algorithm) {
+	this->local = new ConvexHull(localPoints, algorithm);
+	this->transform = { 1, { 0, 0 } };
+}
+
+TransformedHull::~TransformedHull() {
+	delete local;
+}
+
+void TransformedHull::translate(struct vector d) {
+	transform.offset.x += d.x;
+	transform.offset.y += d.y;
+}
+
+void TransformedHull::scaleAbout(double factor, struct point center) {
+	transform.scale *= factor;
+	transform.offset.x = center.x + (transform.offset.x - center.x) * factor;
+	transform.offset.y = center.y + (transform.offset.y - center.y) * factor;
+}
+
+void TransformedHull::setTransform(struct affineTransform transform) {
+	this->transform = transform;
+}
+
+std::vector<struct point> TransformedHull::getHull() {
+	std::vector<struct point> *vertices = local->getHull();
+	std::vector<struct point> result(vertices->size());
+	for (int i = 0; i < vertices->size(); i++)
+		result[i] = apply(transform, (*vertices)[i]);
+	return result;
+}
+
+// The scale is positive, so the farthest vertex along d doesn't change
+struct point TransformedHull::support(struct vector d) {
+	return apply(transform, local->support(d));
+}
+
+bool TransformedHull::containsPoint(struct point p) {
+	local->getHull();
+	return local->containsPoint(invert(transform, p));
+}
+
+static double cross(struct vector a, struct vector b) {
+	return a.x * b.y - a.y * b.x;
+}
+
+/* Minkowski sum of two convex polygons, counter-clockwise from their bottommost vertices, by
+ * walking both edge lists in order of angle. Polygons with no area fall back to summing every
+ * pair of vertices, of which there are at most a few. */
+static std::vector<struct point> mergeEdges(std::vector<struct point> &p, std::vector<struct point> &q) {
+	std::vector<struct point> sum;
+	int n = p.size(), m = q.size();
+	if (n < 3 || m < 3) {
+		for (int i = 0; i < n; i++) {
+			for (int j = 0; j < m; j++)
+				sum.push_back({ p[i].x + q[j].x, p[i].y + q[j].y });
+		}
+		return sum;
+	}
+
+	int i = 0, j = 0;
+	while (i < n || j < m) {
+		sum.push_back({ p[i % n].x + q[j % m].x, p[i % n].y + q[j % m].y });
+		double turn = i == n ? -1 : (j == m ? 1 : cross(makeVectorFromPoints(p[i], p[(i + 1) % n]), makeVectorFromPoints(q[j], q[(j + 1) % m])));
+		if (turn >= 0)
+			i++;
+		if (turn <= 0)
+			j++;
+	}
+	return sum;
+}
+
+/* hull1 + sign * hull2 shifted by shift. Written as scale2 * (scale1 / scale2 * A + sign * B)
+ * plus the offsets, so only the ratio of the scales reaches the local points. */
+static TransformedHull *minkowskiAux(TransformedHull *hull1, TransformedHull *hull2, double sign, struct vector shift) {
+	struct affineTransform t1 = hull1->getTransform(), t2 = hull2->getTransform();
+	double ratio = t1.scale / t2.scale;
+
+	std::vector<struct point> a = strictConvexPolygon(hull1->getLocalHull()->getHull());
+	std::vector<struct point> b = strictConvexPolygon(hull2->getLocalHull()->getHull());
+	for (int i = 0; i < a.size(); i++)
+		a[i] = { a[i].x * ratio, a[i].y * ratio };
+	for (int i = 0; i < b.size(); i++)
+		b[i] = { b[i].x * sign, b[i].y * sign };
+	startAtBottom(&a);
+	startAtBottom(&b);
+
+	TransformedHull *result = new TransformedHull(mergeEdges(a, b), HULL_MONOTONE_CHAIN);
+	result->setTransform({ t2.scale, { t1.offset.x + sign * t2.offset.x + shift.x, t1.offset.y + sign * t2.offset.y + shift.y } });
+	return result;
+}
+
+TransformedHull *TransformedHull::minkowskiSum(TransformedHull *hull1, TransformedHull *hull2, Converter *conv) {
+	struct point origin = conv->getOrigin();
+	return minkowskiAux(hull1, hull2, 1, { -origin.x, -origin.y });
+}
+
+TransformedHull *TransformedHull::minkowskiDifference(TransformedHull *hull1, TransformedHull *hull2, Converter *conv) {
+	struct point origin = conv->getOrigin();
+	return minkowskiAux(hull1, hull2, -1, { origin.x, origin.y });
+}
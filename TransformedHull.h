@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include "DataTypes.h"
+#include "ConvexHull.h"
+#include "Converter.h"
+
+/* A hull built once in its own local space, plus a pending transform: a uniform scale followed
+ * by a translation. Panning and zooming only change the transform, in O(1), and nothing is
+ * hulled again; queries either move the h hull vertices or move the query into local space.
+ * A positive uniform scale keeps the winding and the bottommost vertex, so the transformed
+ * vertices are still counter-clockwise from the bottom like getHull.
+ * The GUI doesn't use it yet: its drags and zooms still move every point and hull them again
+ * through HullWorker.
+ */
+
+/* p -> p * scale + offset, with scale > 0 */
+struct affineTransform {
+	double scale;
+	struct vector offset;
+};
+
+class TransformedHull
+{
+private:
+	ConvexHull *local;
+	struct affineTransform transform;
+
+public:
+	TransformedHull(std::vector<struct point> localPoints, enum HullAlgorithm algorithm = HULL_FARTHEST_POINT);
+	~TransformedHull();
+	// Owns the vectors its pointers point to, so copies would free them twice
+	TransformedHull(const TransformedHull &) = delete;
+	TransformedHull &operator=(const TransformedHull &) = delete;
+
+	void translate(struct vector d);
+	/* Scales by factor > 0 about center, which stays where it is */
+	void scaleAbout(double factor, struct point center);
+	void setTransform(struct affineTransform transform);
+	struct affineTransform getTransform() const { return transform; }
+	ConvexHull *getLocalHull() { return local; }
+
+	/* The hull vertices with the transform applied */
+	std::vector<struct point> getHull();
+	struct point support(struct vector d);
+	bool containsPoint(struct point p);
+
+	/* Like ConvexHull::minkowskiSum and minkowskiDifference, but the conversions through
+	 * conv's grid space only shift the result by its origin, so they fold into the result's
+	 * transform instead of touching any points. The local hulls are combined by merging their
+	 * edges in O(h1 + h2); when both have the same scale the result's local hull doesn't
+	 * depend on either translation. */
+	static TransformedHull *minkowskiSum(TransformedHull *hull1, TransformedHull *hull2, Converter *conv);
+	static TransformedHull *minkowskiDifference(TransformedHull *hull1, TransformedHull *hull2, Converter *conv);
+};
@@ -1,16 +1,21 @@
 #include <windows.h>
 #include <Windowsx.h>
 #include <d2d1.h>
+#include <shellapi.h>
 
 #include "ConvexHull.h"
 #include "DataTypes.h"
 #include "Converter.h"
+#include "HullWorker.h"
+#include "PointStore.h"
+#include "SpatialGrid.h"
+#include "PointGenerator.h"
+#include "HullVerifier.h"
 
-#include <list>
-#include <memory>
 using namespace std;
 
 #pragma comment(lib, "d2d1")
+#pragma comment(lib, "shell32")
 
 #include "basewin.h"
 
@@ -20,6 +25,12 @@ using namespace std;
 #define POINT_CONVEX_HULL 3
 #define GJK 4
 
+// Posted by the hull worker thread whenever it publishes a result
+#define WM_HULL_READY (WM_APP + 1)
+
+// Bounds how long the overlap checks that split the points into batches can take
+#define MAX_ELLIPSES_PER_BATCH 256
+
 template <class T> void SafeRelease(T **ppT)
 {
     if (*ppT)
@@ -83,6 +94,25 @@ struct MyEllipse
     }
 };
 
+static bool intersects(D2D1_RECT_F a, D2D1_RECT_F b) {
+    return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+/* Path geometry for a hull outline, reused for as long as the hull keeps the same vertices */
+struct HullGeometry
+{
+    std::vector<struct point>   points;
+    ID2D1PathGeometry           *geometry;
+};
+
+/* Path geometry for a run of same-colored points, none of which overlap */
+struct EllipseBatch
+{
+    ID2D1PathGeometry           *geometry;
+    D2D1_COLOR_F                color;
+    D2D1_RECT_F                 bounds;     // including the outline
+};
+
 D2D1::ColorF::Enum colors[] = { D2D1::ColorF::Yellow, D2D1::ColorF::Salmon, D2D1::ColorF::LimeGreen };
 
 
@@ -102,6 +132,7 @@ class MainWindow : public BaseWindow<MainWindow>
     ID2D1Factory            *pFactory;
     ID2D1HwndRenderTarget   *pRenderTarget;
     ID2D1SolidColorBrush    *pBrush;
+    ID2D1BitmapRenderTarget *pStaticLayer;
     D2D1_POINT_2F           ptMouse;
     Mode                    mode;
 
@@ -112,6 +143,38 @@ class MainWindow : public BaseWindow<MainWindow>
     int                     hullSelected;
     std::vector<struct point>* temp = new std::vector<struct point>;
 
+    /* While a single hull is dragged everything else is drawn once into pStaticLayer,
+     * and each frame only redraws the area the moving hull covers now or covered last frame.
+     * layerMovingHull is the hull left out of pStaticLayer, or -1 if the layer is stale, and
+     * layerScenario the scenario it was drawn for, since a new one redraws every hull. */
+    int                     layerMovingHull = -1;
+    int                     layerScenario = -1;
+    D2D1_RECT_F             movingBounds;
+
+    /* Geometry is built once per change and drawn with a single call. The grid is
+     * rebuilt only when gridLength, origin or the client size change. */
+    ID2D1PathGeometry       *pGridGeometry = NULL;
+    double                  gridGeometryLength;
+    struct point            gridGeometryOrigin;
+    RECT                    gridGeometryClient;
+    std::vector<HullGeometry> hullGeometries;
+    int                     nextHullGeometry = 0;
+
+    /* The points are drawn from batches rebuilt only after AddEllipse, EllipseMoved or
+     * ClearEllipses. No two points in a batch overlap, so drawing all of a batch's outlines and
+     * then all its fills paints the same as MyEllipse::Draw on one point after another. */
+    std::vector<EllipseBatch> ellipseBatches;
+    bool                    ellipseBatchesStale = true;
+
+    /* Hulls are computed by the worker; paints submit the current point sets and draw the
+     * newest result. scenario changes whenever a Paint* function generates new points. */
+    HullWorker              *worker = NULL;
+    int                     scenario = 0;
+    struct hullJob          submittedJob;
+    unsigned long long      submittedGeneration = 0;
+    struct hullResult       syncResult;
+    unsigned long long      hullGenerations[2] = { 0, 0 };    // of the results hulls[0] and hulls[1] were built from
+
     struct point            origin;
     struct point            originOriginal;
     double                  horizontalOriginalY;
@@ -125,30 +188,36 @@ class MainWindow : public BaseWindow<MainWindow>
     int                     oldScale = 5;
     double                  gridLength = 25;
 
-    list<shared_ptr<MyEllipse>>             ellipses;
-    list<shared_ptr<MyEllipse>>::iterator   selection;
+    /* Points live contiguously in ellipses; selection is a handle into it. pointIndex is a
+     * uniform grid over the same handles for hit testing, kept current by EllipseMoved. */
+    PointStore<MyEllipse>   ellipses;
+    int                     selection;
+    SpatialGrid             pointIndex = SpatialGrid(32);
      
-    shared_ptr<MyEllipse> Selection() 
-    { 
-        if (selection == ellipses.end()) 
-        { 
-            return nullptr;
-        }
-        else
-        {
-            return (*selection);
-        }
-    }
+    MyEllipse *Selection() { return ellipses.get(selection); }
 
-    void    ClearSelection() { selection = ellipses.end(); }
+    void    ClearSelection() { selection = PointStore<MyEllipse>::InvalidHandle; }
+    void    AddEllipse(D2D1_ELLIPSE ellipse, D2D1_COLOR_F color);
+    void    ClearEllipses();
+    void    EllipseMoved(int index);
     BOOL    HitTest(float x, float y);
     void    SetMode(Mode m);
     void    MoveSelection(float x, float y);
     HRESULT CreateGraphicsResources();
     void    DiscardGraphicsResources();
-    void    DrawConvexHull(std::vector<struct point> *hullPoints, D2D1::ColorF color);
-    void    DrawGrid();
-    void    DrawAxis();
+    void    DiscardGeometry();
+    HRESULT BuildEllipseBatches();
+    void    ReleaseEllipseBatches();
+    HRESULT CreatePolygonGeometry(const std::vector<struct point> *points, ID2D1PathGeometry **ppGeometry);
+    ID2D1PathGeometry *GetHullGeometry(const std::vector<struct point> *hullPoints);
+    void    DrawConvexHull(ID2D1RenderTarget *pRT, const std::vector<struct point> *hullPoints, D2D1::ColorF color);
+    void    DrawEllipses(ID2D1RenderTarget *pRT, const D2D1_RECT_F *clip);
+    void    DrawGrid(ID2D1RenderTarget *pRT);
+    void    DrawAxis(ID2D1RenderTarget *pRT);
+    int     MovingHull();
+    HRESULT RenderStaticLayer(const std::vector<struct point> *staticHull);
+    const struct hullResult *Hulls(struct hullJob &job);
+    void    SetHull(int index, const struct hullResult *result, const std::vector<struct point> *hullPoints);
     void    OnPaintDefault();
     void    OnPaintSelect();
     void    PaintMinkowskiGJK();
@@ -165,8 +234,8 @@ class MainWindow : public BaseWindow<MainWindow>
 
 public:
 
-    MainWindow() : pFactory(NULL), pRenderTarget(NULL), pBrush(NULL), 
-        ptMouse(D2D1::Point2F()), selection(ellipses.end())
+    MainWindow() : pFactory(NULL), pRenderTarget(NULL), pBrush(NULL), pStaticLayer(NULL),
+        ptMouse(D2D1::Point2F()), selection(PointStore<MyEllipse>::InvalidHandle)
     {
     }
 
@@ -184,9 +253,10 @@ HRESULT MainWindow::CreateGraphicsResources()
 
         D2D1_SIZE_U size = D2D1::SizeU(rc.right, rc.bottom);
 
+        // The back buffer is kept between frames so a drag can repaint just its dirty area
         hr = pFactory->CreateHwndRenderTarget(
             D2D1::RenderTargetProperties(),
-            D2D1::HwndRenderTargetProperties(m_hwnd, size),
+            D2D1::HwndRenderTargetProperties(m_hwnd, size, D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS),
             &pRenderTarget);
 
         if (SUCCEEDED(hr))
@@ -200,49 +270,331 @@ HRESULT MainWindow::CreateGraphicsResources()
 
 void MainWindow::DiscardGraphicsResources()
 {
+    SafeRelease(&pStaticLayer);
     SafeRelease(&pRenderTarget);
     SafeRelease(&pBrush);
+    layerMovingHull = -1;
+}
+
+void MainWindow::DiscardGeometry()
+{
+    SafeRelease(&pGridGeometry);
+    for (int i = 0; i < hullGeometries.size(); i++)
+        SafeRelease(&hullGeometries[i].geometry);
+    hullGeometries.clear();
+    nextHullGeometry = 0;
+    ReleaseEllipseBatches();
+}
+
+HRESULT MainWindow::CreatePolygonGeometry(const std::vector<struct point> *points, ID2D1PathGeometry **ppGeometry)
+{
+    ID2D1GeometrySink *pSink = NULL;
+    HRESULT hr = pFactory->CreatePathGeometry(ppGeometry);
+    if (SUCCEEDED(hr))
+    {
+        hr = (*ppGeometry)->Open(&pSink);
+    }
+    if (SUCCEEDED(hr))
+    {
+        pSink->BeginFigure(D2D1::Point2F((*points)[0].x, (*points)[0].y), D2D1_FIGURE_BEGIN_HOLLOW);
+        for (int i = 1; i < points->size(); i++)
+            pSink->AddLine(D2D1::Point2F((*points)[i].x, (*points)[i].y));
+        pSink->EndFigure(D2D1_FIGURE_END_CLOSED);
+        hr = pSink->Close();
+    }
+    SafeRelease(&pSink);
+    if (FAILED(hr))
+    {
+        SafeRelease(ppGeometry);
+    }
+    return hr;
+}
+
+/* Looks the hull up in a small round-robin cache so hulls that didn't move keep their geometry */
+ID2D1PathGeometry *MainWindow::GetHullGeometry(const std::vector<struct point> *hullPoints)
+{
+    const int cacheSize = 8;
+
+    for (int i = 0; i < hullGeometries.size(); i++) {
+        const std::vector<struct point> *cached = &hullGeometries[i].points;
+        if (cached->size() != hullPoints->size())
+            continue;
+
+        int j = 0;
+        while (j < cached->size() && (*cached)[j].x == (*hullPoints)[j].x && (*cached)[j].y == (*hullPoints)[j].y)
+            j++;
+        if (j == cached->size())
+            return hullGeometries[i].geometry;
+    }
+
+    HullGeometry entry = { *hullPoints, NULL };
+    if (FAILED(CreatePolygonGeometry(hullPoints, &entry.geometry)))
+        return NULL;
+
+    if (hullGeometries.size() < cacheSize) {
+        hullGeometries.push_back(entry);
+    }
+    else {
+        SafeRelease(&hullGeometries[nextHullGeometry].geometry);
+        hullGeometries[nextHullGeometry] = entry;
+        nextHullGeometry = (nextHullGeometry + 1) % cacheSize;
+    }
+    return entry.geometry;
+}
+
+void MainWindow::DrawConvexHull(ID2D1RenderTarget *pRT, const std::vector<struct point> *hullPoints, D2D1::ColorF color) {
+    if (hullPoints->size() == 0)
+        return;
+
+    ID2D1PathGeometry *pGeometry = GetHullGeometry(hullPoints);
+    if (pGeometry) {
+        pBrush->SetColor(color);
+        pRT->DrawGeometry(pGeometry, pBrush, 2);
+    }
+}
+
+static void addEllipseFigure(ID2D1GeometrySink *pSink, D2D1_ELLIPSE e) {
+    D2D1_SIZE_F radius = D2D1::SizeF(e.radiusX, e.radiusY);
+
+    pSink->BeginFigure(D2D1::Point2F(e.point.x - e.radiusX, e.point.y), D2D1_FIGURE_BEGIN_FILLED);
+    pSink->AddArc(D2D1::ArcSegment(D2D1::Point2F(e.point.x + e.radiusX, e.point.y), radius, 0, D2D1_SWEEP_DIRECTION_CLOCKWISE, D2D1_ARC_SIZE_SMALL));
+    pSink->AddArc(D2D1::ArcSegment(D2D1::Point2F(e.point.x - e.radiusX, e.point.y), radius, 0, D2D1_SWEEP_DIRECTION_CLOCKWISE, D2D1_ARC_SIZE_SMALL));
+    pSink->EndFigure(D2D1_FIGURE_END_CLOSED);
+}
+
+static bool sameColor(D2D1_COLOR_F a, D2D1_COLOR_F b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
 }
 
-void MainWindow::DrawConvexHull(std::vector<struct point> *hullPoints, D2D1::ColorF color) {
-    pBrush->SetColor(color);
+void MainWindow::ReleaseEllipseBatches()
+{
+    for (int i = 0; i < ellipseBatches.size(); i++)
+        SafeRelease(&ellipseBatches[i].geometry);
+    ellipseBatches.clear();
+    ellipseBatchesStale = true;
+}
+
+/* Splits the points, in drawing order, into runs of the same color where no point's outline
+ * touches another's in the same run */
+HRESULT MainWindow::BuildEllipseBatches()
+{
+    ReleaseEllipseBatches();
+
+    std::vector<D2D1_RECT_F> members;
+    auto i = ellipses.begin();
+    while (i != ellipses.end())
+    {
+        EllipseBatch batch = { NULL, i->color, D2D1::RectF(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX) };
+        ID2D1GeometrySink *pSink = NULL;
+
+        HRESULT hr = pFactory->CreatePathGeometry(&batch.geometry);
+        if (SUCCEEDED(hr))
+        {
+            hr = batch.geometry->Open(&pSink);
+        }
+        if (FAILED(hr))
+        {
+            SafeRelease(&batch.geometry);
+            return hr;
+        }
+
+        // Both arcs of every figure turn the same way, so the figures are filled alike
+        pSink->SetFillMode(D2D1_FILL_MODE_WINDING);
+        members.clear();
+        for (; i != ellipses.end() && sameColor(i->color, batch.color) && members.size() < MAX_ELLIPSES_PER_BATCH; ++i)
+        {
+            D2D1_ELLIPSE e = i->ellipse;
+            D2D1_RECT_F extent = D2D1::RectF(e.point.x - e.radiusX - 3, e.point.y - e.radiusY - 3, e.point.x + e.radiusX + 3, e.point.y + e.radiusY + 3);
+            bool overlaps = false;
+            for (int k = 0; k < members.size() && !overlaps; k++)
+                overlaps = intersects(members[k], extent);
+            if (overlaps)
+                break;
+
+            members.push_back(extent);
+            addEllipseFigure(pSink, e);
+            batch.bounds = D2D1::RectF(min(batch.bounds.left, extent.left), min(batch.bounds.top, extent.top),
+                max(batch.bounds.right, extent.right), max(batch.bounds.bottom, extent.bottom));
+        }
 
-    for (int i = 0; i < hullPoints->size() - 1; i++) {
-        pRenderTarget->DrawLine(D2D1::Point2F((*hullPoints)[i].x, (*hullPoints)[i].y),
-            D2D1::Point2F((*hullPoints)[i + 1].x, (*hullPoints)[i + 1].y),
-            pBrush, 2);
+        hr = pSink->Close();
+        SafeRelease(&pSink);
+        if (FAILED(hr))
+        {
+            SafeRelease(&batch.geometry);
+            return hr;
+        }
+        ellipseBatches.push_back(batch);
     }
 
-    pRenderTarget->DrawLine(D2D1::Point2F((*hullPoints)[hullPoints->size() - 1].x, (*hullPoints)[hullPoints->size() - 1].y),
-        D2D1::Point2F((*hullPoints)[0].x, (*hullPoints)[0].y),
-        pBrush, 2);
+    ellipseBatchesStale = false;
+    return S_OK;
 }
 
-void MainWindow::DrawGrid() {
+/* Draws the ellipses (only the batches touching clip, if it isn't NULL) the way MyEllipse::Draw
+ * does, with one outline and one fill call per batch */
+void MainWindow::DrawEllipses(ID2D1RenderTarget *pRT, const D2D1_RECT_F *clip)
+{
+    if (ellipseBatchesStale && FAILED(BuildEllipseBatches()))
+        return;
+
+    for (int i = 0; i < ellipseBatches.size(); i++)
+    {
+        const EllipseBatch &batch = ellipseBatches[i];
+        if (clip != NULL && !intersects(*clip, batch.bounds))
+            continue;
+        pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::White));
+        pRT->DrawGeometry(batch.geometry, pBrush, 5.f);
+        pBrush->SetColor(batch.color);
+        pRT->FillGeometry(batch.geometry, pBrush);
+    }
+}
+
+void MainWindow::DrawGrid(ID2D1RenderTarget *pRT) {
     RECT rc;
     GetClientRect(m_hwnd, &rc);
-    pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::White));
-    double thickness = 0.35;
 
-    for (int i = origin.x; i < rc.right; i = i + gridLength)
-        pRenderTarget->DrawLine(D2D1::Point2F(i, 0), D2D1::Point2F(i, rc.bottom), pBrush, thickness);
+    if (pGridGeometry == NULL || gridGeometryLength != gridLength || gridGeometryOrigin.x != origin.x || gridGeometryOrigin.y != origin.y ||
+        gridGeometryClient.right != rc.right || gridGeometryClient.bottom != rc.bottom)
+    {
+        ID2D1GeometrySink *pSink = NULL;
+        SafeRelease(&pGridGeometry);
 
-    for (int i = origin.x; i > rc.left; i = i - gridLength)
-        pRenderTarget->DrawLine(D2D1::Point2F(i, 0), D2D1::Point2F(i, rc.bottom), pBrush, thickness);
+        HRESULT hr = pFactory->CreatePathGeometry(&pGridGeometry);
+        if (SUCCEEDED(hr))
+        {
+            hr = pGridGeometry->Open(&pSink);
+        }
+        if (SUCCEEDED(hr))
+        {
+            for (int i = origin.x; i < rc.right; i = i + gridLength) {
+                pSink->BeginFigure(D2D1::Point2F(i, 0), D2D1_FIGURE_BEGIN_HOLLOW);
+                pSink->AddLine(D2D1::Point2F(i, rc.bottom));
+                pSink->EndFigure(D2D1_FIGURE_END_OPEN);
+            }
+
+            for (int i = origin.x; i > rc.left; i = i - gridLength) {
+                pSink->BeginFigure(D2D1::Point2F(i, 0), D2D1_FIGURE_BEGIN_HOLLOW);
+                pSink->AddLine(D2D1::Point2F(i, rc.bottom));
+                pSink->EndFigure(D2D1_FIGURE_END_OPEN);
+            }
 
-    for (int i = origin.y; i < rc.bottom; i = i + gridLength)
-        pRenderTarget->DrawLine(D2D1::Point2F(0, i), D2D1::Point2F(rc.right, i), pBrush, thickness);
+            for (int i = origin.y; i < rc.bottom; i = i + gridLength) {
+                pSink->BeginFigure(D2D1::Point2F(0, i), D2D1_FIGURE_BEGIN_HOLLOW);
+                pSink->AddLine(D2D1::Point2F(rc.right, i));
+                pSink->EndFigure(D2D1_FIGURE_END_OPEN);
+            }
 
-    for (int i = origin.y; i > rc.top; i = i - gridLength)
-        pRenderTarget->DrawLine(D2D1::Point2F(0, i), D2D1::Point2F(rc.right, i), pBrush, thickness);
+            for (int i = origin.y; i > rc.top; i = i - gridLength) {
+                pSink->BeginFigure(D2D1::Point2F(0, i), D2D1_FIGURE_BEGIN_HOLLOW);
+                pSink->AddLine(D2D1::Point2F(rc.right, i));
+                pSink->EndFigure(D2D1_FIGURE_END_OPEN);
+            }
+
+            hr = pSink->Close();
+        }
+        SafeRelease(&pSink);
+        if (FAILED(hr))
+        {
+            SafeRelease(&pGridGeometry);
+            return;
+        }
+
+        gridGeometryLength = gridLength;
+        gridGeometryOrigin = origin;
+        gridGeometryClient = rc;
+    }
+
+    pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::White));
+    pRT->DrawGeometry(pGridGeometry, pBrush, 0.35);
 }
 
-void MainWindow::DrawAxis() {
+void MainWindow::DrawAxis(ID2D1RenderTarget *pRT) {
     RECT rc;
     GetClientRect(m_hwnd, &rc);
     pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::Gray));
-    pRenderTarget->DrawLine(D2D1::Point2F(0, horizontalY), D2D1::Point2F(rc.right, horizontalY), pBrush, 5);
-    pRenderTarget->DrawLine(D2D1::Point2F(verticalX, 0), D2D1::Point2F(verticalX, rc.bottom), pBrush, 5);
+    pRT->DrawLine(D2D1::Point2F(0, horizontalY), D2D1::Point2F(rc.right, horizontalY), pBrush, 5);
+    pRT->DrawLine(D2D1::Point2F(verticalX, 0), D2D1::Point2F(verticalX, rc.bottom), pBrush, 5);
+}
+
+/* Returns the index of the hull being dragged in the Minkowski/GJK modes, or -1 if the
+ * whole scene has to be redrawn */
+int MainWindow::MovingHull() {
+    if (mode == DragHull1)
+        return hullSelected;
+
+    if (mode == DragMode && Selection())
+        return ellipses.indexOf(selection) < ellipses.size() / 2 ? 0 : 1;
+
+    return -1;
+}
+
+/* Draws the grid, the axes and the hull that isn't moving into the static layer */
+HRESULT MainWindow::RenderStaticLayer(const std::vector<struct point> *staticHull) {
+    HRESULT hr = S_OK;
+    if (pStaticLayer == NULL)
+        hr = pRenderTarget->CreateCompatibleRenderTarget(&pStaticLayer);
+
+    if (SUCCEEDED(hr))
+    {
+        pStaticLayer->BeginDraw();
+        pStaticLayer->Clear(D2D1::ColorF(D2D1::ColorF::Black));
+        DrawGrid(pStaticLayer);
+        DrawAxis(pStaticLayer);
+        DrawConvexHull(pStaticLayer, staticHull, D2D1::ColorF(D2D1::ColorF::White));
+        hr = pStaticLayer->EndDraw();
+    }
+    return hr;
+}
+
+/* Hands the job to the worker if it differs from the last one submitted and returns the newest
+ * result for the current scenario. Until the worker has one, the job is computed right here. */
+const struct hullResult *MainWindow::Hulls(struct hullJob &job)
+{
+    job.scenario = scenario;
+    if (submittedGeneration == 0 || !sameHullJob(job, submittedJob))
+    {
+        submittedJob = job;
+        submittedGeneration = worker->submit(job);
+    }
+
+    const struct hullResult *result = worker->latest();
+    if (result == NULL || result->scenario != scenario)
+    {
+        /* Nothing from the worker for this scenario yet. Rather than computing it here on the
+         * UI thread, show the hulls the Paint* function built until the worker's result
+         * arrives; its WM_HULL_READY repaints. Generation 0 marks this as a placeholder. */
+        syncResult.generation = 0;
+        syncResult.scenario = scenario;
+        syncResult.hull1 = hulls->size() > 0 ? *(*hulls)[0]->getHull() : std::vector<struct point>();
+        syncResult.hull2 = hulls->size() > 1 ? *(*hulls)[1]->getHull() : std::vector<struct point>();
+        syncResult.combined.clear();
+        syncResult.containsPoint = job.kind == HULL_CONTAINS_JOB && hulls->size() > 0 && job.set2.size() > 0 &&
+            (*hulls)[0]->containsPoint(job.set2[0]);
+        result = &syncResult;
+    }
+    return result;
+}
+
+/* Replaces hulls[index], which is used for hit testing, with the hull of a worker result.
+ * Paints repeat until the next result arrives, so the hull is only rebuilt for a new one. */
+void MainWindow::SetHull(int index, const struct hullResult *result, const std::vector<struct point> *hullPoints)
+{
+    if (result->generation == 0 || result->generation == hullGenerations[index])
+        return;
+
+    ConvexHull *hull = new ConvexHull(*hullPoints);
+    hull->getHull();
+    delete (*hulls)[index];
+    (*hulls)[index] = hull;
+    hullGenerations[index] = result->generation;
+}
+
+static void growBounds(D2D1_RECT_F *bounds, float x, float y, float margin) {
+    bounds->left = min(bounds->left, x - margin);
+    bounds->top = min(bounds->top, y - margin);
+    bounds->right = max(bounds->right, x + margin);
+    bounds->bottom = max(bounds->bottom, y + margin);
 }
 
 void MainWindow::OnPaintDefault()
@@ -298,8 +650,9 @@ void MainWindow::PaintMinkowskiGJK()
     if (SUCCEEDED(hr))
     {
         PAINTSTRUCT ps;
-        ellipses.clear();
+        ClearEllipses();
         hulls->clear();
+        scenario++;
         scale = 5;
         BeginPaint(m_hwnd, &ps);
 
@@ -315,63 +668,53 @@ void MainWindow::PaintMinkowskiGJK()
         origin = { rc.right / 2.f, rc.bottom / 2.f };
         conv->setOrigin(origin.x, origin.y);
 
-        DrawGrid();
-        DrawAxis();
+        DrawGrid(pRenderTarget);
+        DrawAxis(pRenderTarget);
 
         int rightLimit = rc.right / 6.f - 50;
         int bottomLimit = rc.bottom / 6.f - 50;
 
-        std::vector<struct point>* points = new std::vector<struct point>();
+        struct point low1 = { rc.right / 2.f + 20, 2 * rc.bottom / 6.f + 20 };
+        std::vector<struct point>* points = new std::vector<struct point>(generatePoints(
+            makePointWorkload(UNIFORM_POINTS, 2 * scenario, low1, { low1.x + rightLimit, low1.y + bottomLimit }, true), 6));
 
         for (int i = 0; i < 6; i++) {
-            int x = rand() % rightLimit + (rc.right / 2.f + 20);
-            int y = rand() % bottomLimit + (2 * rc.bottom / 6.f + 20);
-
-            struct point p = { x, y };
-            points->push_back(p);
+            int x = (*points)[i].x;
+            int y = (*points)[i].y;
 
             D2D1_ELLIPSE point = D2D1::Ellipse(D2D1::Point2F(x, y), 10, 10);
-            shared_ptr<MyEllipse> newEllipse = shared_ptr<MyEllipse>(new MyEllipse());
-            newEllipse->ellipse = point;
-            newEllipse->color = D2D1::ColorF(D2D1::ColorF::Green);
-            ellipses.insert(ellipses.end(), newEllipse);
+            AddEllipse(point, D2D1::ColorF(D2D1::ColorF::Green));
         }
 
         ConvexHull* hull1 = new ConvexHull(*points);
         hulls->push_back(hull1);
-        DrawConvexHull(hull1->getHull(), D2D1::ColorF(D2D1::ColorF::White));
+        DrawConvexHull(pRenderTarget, hull1->getHull(), D2D1::ColorF(D2D1::ColorF::White));
 
         /////////////////////////////////////////////////////////////////////////////////////////
 
-        points->clear();
+        struct point low2 = { 4 * (rc.right / 6.f), rc.bottom / 6.f };
+        *points = generatePoints(makePointWorkload(UNIFORM_POINTS, 2 * scenario + 1, low2, { low2.x + rightLimit, low2.y + bottomLimit }, true), 6);
 
         for (int i = 0; i < 6; i++) {
-            int x = rand() % rightLimit + (4 * (rc.right / 6.f));
-            int y = rand() % bottomLimit + (rc.bottom / 6.f);
-
-            struct point p = { x, y };
-            points->push_back(p);
+            int x = (*points)[i].x;
+            int y = (*points)[i].y;
 
             D2D1_ELLIPSE point = D2D1::Ellipse(D2D1::Point2F(x, y), 10, 10);
-            shared_ptr<MyEllipse> newEllipse = shared_ptr<MyEllipse>(new MyEllipse());
-            newEllipse->ellipse = point;
-            newEllipse->color = D2D1::ColorF(D2D1::ColorF::Green);
-            ellipses.insert(ellipses.end(), newEllipse);
+            AddEllipse(point, D2D1::ColorF(D2D1::ColorF::Green));
         }
 
         ConvexHull* hull2 = new ConvexHull(*points);
         hulls->push_back(hull2);
-        DrawConvexHull(hull2->getHull(), D2D1::ColorF(D2D1::ColorF::White));
+        DrawConvexHull(pRenderTarget, hull2->getHull(), D2D1::ColorF(D2D1::ColorF::White));
 
         delete points;
 
         /////////////////////////////////////////////////////////////////////////////////////////
         
         ConvexHull* newHull = paintMode == MINKOWSKI_SUM ? hull1->minkowskiSum(hull1, hull2, conv) : hull1->minkowskiDifference(hull1, hull2, conv);
-        DrawConvexHull(newHull->getHull(), D2D1::ColorF(D2D1::ColorF::Magenta));
+        DrawConvexHull(pRenderTarget, newHull->getHull(), D2D1::ColorF(D2D1::ColorF::Magenta));
 
-        for (auto i = ellipses.begin(); i != ellipses.end(); ++i)
-            (*i)->Draw(pRenderTarget, pBrush);
+        DrawEllipses(pRenderTarget, NULL);
 
         hr = pRenderTarget->EndDraw();
         if (FAILED(hr) || hr == D2DERR_RECREATE_TARGET)
@@ -389,114 +732,164 @@ void MainWindow::UpdateMinkowskiGJK() {
         PAINTSTRUCT ps;
         BeginPaint(m_hwnd, &ps);
 
-        pRenderTarget->BeginDraw();
-        pRenderTarget->Clear(D2D1::ColorF(D2D1::ColorF::Black));
-
         RECT rc;
         GetClientRect(m_hwnd, &rc);
         
+        int movingHull = oldScale != scale ? -1 : MovingHull();
         gridLength = 25 + (scale - 5) * 3;
-        DrawGrid();
-        DrawAxis();
 
         std::vector<struct point> *points = new std::vector<struct point>();
 
         for (int i = 0; i < ellipses.size() / 2; i++) {
-            auto iterator = ellipses.begin();
-            std::advance(iterator, i);
+            MyEllipse *current = &ellipses[i];
 
-            double xDisplace = ((*iterator)->ellipse.point.x - origin.x);
+            double xDisplace = (current->ellipse.point.x - origin.x);
             xDisplace /= gridLength;
             xDisplace *= 3;
 
-            double yDisplace = -1 * ((*iterator)->ellipse.point.y - origin.y);
+            double yDisplace = -1 * (current->ellipse.point.y - origin.y);
             yDisplace /= gridLength;
             yDisplace *= 3;
 
             if (oldScale != scale) {
                 if (scale > oldScale) {
-                    (*iterator)->ellipse.point.x += xDisplace;
-                    (*iterator)->ellipse.point.y -= yDisplace;
+                    current->ellipse.point.x += xDisplace;
+                    current->ellipse.point.y -= yDisplace;
                     
-                    (*iterator)->ellipse.radiusX += 1;
-                    (*iterator)->ellipse.radiusY += 1;
+                    current->ellipse.radiusX += 1;
+                    current->ellipse.radiusY += 1;
                 }
                 else {
-                    (*iterator)->ellipse.point.x -= xDisplace;
-                    (*iterator)->ellipse.point.y += yDisplace;
+                    current->ellipse.point.x -= xDisplace;
+                    current->ellipse.point.y += yDisplace;
                     
-                    (*iterator)->ellipse.radiusX -= 1;
-                    (*iterator)->ellipse.radiusY -= 1;
+                    current->ellipse.radiusX -= 1;
+                    current->ellipse.radiusY -= 1;
                 }
+                EllipseMoved(i);
             }
             
-            struct point p = { (*iterator)->ellipse.point.x, (*iterator)->ellipse.point.y };
+            struct point p = { current->ellipse.point.x, current->ellipse.point.y };
             points->push_back(p);
         }
 
-        ConvexHull* hull1 = new ConvexHull(*points);
-        (*hulls)[0] = hull1;
-        DrawConvexHull(hull1->getHull(), D2D1::ColorF(D2D1::ColorF::White));
+        struct hullJob job;
+        job.kind = paintMode == MINKOWSKI_SUM ? MINKOWSKI_SUM_JOB : MINKOWSKI_DIFFERENCE_JOB;
+        job.set1 = *points;
 
         ///////////////////////////////////////////////
 
         points->clear();
 
         for (int i = ellipses.size() / 2; i < ellipses.size(); i++) {
-            auto iterator = ellipses.begin();
-            std::advance(iterator, i);
+            MyEllipse *current = &ellipses[i];
 
-            double xDisplace = ((*iterator)->ellipse.point.x - origin.x);
+            double xDisplace = (current->ellipse.point.x - origin.x);
             xDisplace /= gridLength;
             xDisplace *= 3;
 
-            double yDisplace = -1 * ((*iterator)->ellipse.point.y - origin.y);
+            double yDisplace = -1 * (current->ellipse.point.y - origin.y);
             yDisplace /= gridLength;
             yDisplace *= 3;
 
             if (oldScale != scale) {
                 if (scale > oldScale) {
-                    (*iterator)->ellipse.point.x += xDisplace;
-                    (*iterator)->ellipse.point.y -= yDisplace;
+                    current->ellipse.point.x += xDisplace;
+                    current->ellipse.point.y -= yDisplace;
                     
-                    (*iterator)->ellipse.radiusX += 1;
-                    (*iterator)->ellipse.radiusY += 1;
+                    current->ellipse.radiusX += 1;
+                    current->ellipse.radiusY += 1;
                 }
                 else {
-                    (*iterator)->ellipse.point.x -= xDisplace;
-                    (*iterator)->ellipse.point.y += yDisplace;
+                    current->ellipse.point.x -= xDisplace;
+                    current->ellipse.point.y += yDisplace;
                     
-                    (*iterator)->ellipse.radiusX -= 1;
-                    (*iterator)->ellipse.radiusY -= 1;
+                    current->ellipse.radiusX -= 1;
+                    current->ellipse.radiusY -= 1;
                 }
+                EllipseMoved(i);
             }
 
-            struct point p = { (*iterator)->ellipse.point.x, (*iterator)->ellipse.point.y };
+            struct point p = { current->ellipse.point.x, current->ellipse.point.y };
             points->push_back(p);
         }
 
         oldScale = scale;
         
-        ConvexHull *hull2 = new ConvexHull(*points);
-        (*hulls)[1] = hull2;
-        DrawConvexHull(hull2->getHull(), D2D1::ColorF(D2D1::ColorF::White));
+        job.set2 = *points;
+        job.conv = *conv;
+        job.origin = origin;
 
         delete points;
 
         /////////////////////////////////////////////////////////////////////////////////////////
 
-        ConvexHull* newHull = paintMode == MINKOWSKI_SUM ? hull1->minkowskiSum(hull1, hull2, conv) : hull1->minkowskiDifference(hull1, hull2, conv);
+        const struct hullResult *result = Hulls(job);
+        SetHull(0, result, &result->hull1);
+        SetHull(1, result, &result->hull2);
+
+        if (movingHull != layerMovingHull || scenario != layerScenario)
+        {
+            // The static layer is only built from a result that matches the points on screen
+            layerMovingHull = -1;
+            if (movingHull != -1 && result->generation == submittedGeneration &&
+                SUCCEEDED(RenderStaticLayer(movingHull == 0 ? &result->hull2 : &result->hull1)))
+            {
+                layerMovingHull = movingHull;
+                layerScenario = scenario;
+            }
+        }
+
+        pRenderTarget->BeginDraw();
 
-        if (paintMode == GJK)
-            if (newHull->containsPoint(origin))
-                DrawConvexHull(newHull->getHull(), D2D1::ColorF(D2D1::ColorF::LimeGreen));
-            else
-                DrawConvexHull(newHull->getHull(), D2D1::ColorF(D2D1::ColorF::Magenta));
+        D2D1_RECT_F dirty = D2D1::RectF(0, 0, rc.right, rc.bottom);
+        if (layerMovingHull == -1)
+        {
+            pRenderTarget->Clear(D2D1::ColorF(D2D1::ColorF::Black));
+            DrawGrid(pRenderTarget);
+            DrawAxis(pRenderTarget);
+            DrawConvexHull(pRenderTarget, &result->hull1, D2D1::ColorF(D2D1::ColorF::White));
+            DrawConvexHull(pRenderTarget, &result->hull2, D2D1::ColorF(D2D1::ColorF::White));
+            movingBounds = dirty;
+        }
         else
-            DrawConvexHull(newHull->getHull(), D2D1::ColorF(D2D1::ColorF::Magenta));
+        {
+            // The area covered by the moving hull, its points and the Minkowski hull
+            D2D1_RECT_F bounds = D2D1::RectF(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+            const std::vector<struct point> *moving = layerMovingHull == 0 ? &result->hull1 : &result->hull2;
+            for (int i = 0; i < moving->size(); i++)
+                growBounds(&bounds, (*moving)[i].x, (*moving)[i].y, 2);
+            const std::vector<struct point> *minkowski = &result->combined;
+            for (int i = 0; i < minkowski->size(); i++)
+                growBounds(&bounds, (*minkowski)[i].x, (*minkowski)[i].y, 2);
+            int first = layerMovingHull == 0 ? 0 : ellipses.size() / 2;
+            int last = layerMovingHull == 0 ? ellipses.size() / 2 : ellipses.size();
+            for (int i = first; i < last; i++)
+                growBounds(&bounds, ellipses[i].ellipse.point.x, ellipses[i].ellipse.point.y, ellipses[i].ellipse.radiusX + 3);
+
+            dirty = D2D1::RectF(min(bounds.left, movingBounds.left), min(bounds.top, movingBounds.top),
+                max(bounds.right, movingBounds.right), max(bounds.bottom, movingBounds.bottom));
+            movingBounds = bounds;
+
+            pRenderTarget->PushAxisAlignedClip(dirty, D2D1_ANTIALIAS_MODE_ALIASED);
+            ID2D1Bitmap *pStaticBitmap = NULL;
+            if (SUCCEEDED(pStaticLayer->GetBitmap(&pStaticBitmap)))
+            {
+                pRenderTarget->DrawBitmap(pStaticBitmap);
+                SafeRelease(&pStaticBitmap);
+            }
+            DrawConvexHull(pRenderTarget, moving, D2D1::ColorF(D2D1::ColorF::White));
+        }
 
-        for (auto i = ellipses.begin(); i != ellipses.end(); ++i)
-            (*i)->Draw(pRenderTarget, pBrush);
+        if (paintMode == GJK && result->containsPoint)
+            DrawConvexHull(pRenderTarget, &result->combined, D2D1::ColorF(D2D1::ColorF::LimeGreen));
+        else
+            DrawConvexHull(pRenderTarget, &result->combined, D2D1::ColorF(D2D1::ColorF::Magenta));
+
+        DrawEllipses(pRenderTarget, &dirty);
+
+        if (layerMovingHull != -1)
+            pRenderTarget->PopAxisAlignedClip();
 
         hr = pRenderTarget->EndDraw();
         if (FAILED(hr) || hr == D2DERR_RECREATE_TARGET)
@@ -513,8 +906,9 @@ void MainWindow::PaintQuickhull()
     if (SUCCEEDED(hr))
     {
         PAINTSTRUCT ps;
-        ellipses.clear();
+        ClearEllipses();
         hulls->clear();
+        scenario++;
         BeginPaint(m_hwnd, &ps);
 
         pRenderTarget->BeginDraw();
@@ -525,31 +919,25 @@ void MainWindow::PaintQuickhull()
         int rightLimit = rc.right - 200 - 500;
         int bottomLimit = rc.bottom - 200 - 150;
 
-        std::vector<struct point> *points = new std::vector<struct point>();
+        std::vector<struct point> *points = new std::vector<struct point>(generatePoints(
+            makePointWorkload(UNIFORM_POINTS, scenario, { 500, 150 }, { 500.0 + rightLimit, 150.0 + bottomLimit }, true), 15));
 
         for (int i = 0; i < 15; i++) {
-            int x = rand() % rightLimit + 500;
-            int y = rand() % bottomLimit + 150;
-
-            struct point p = {x, y};
-            points->push_back(p);
+            int x = (*points)[i].x;
+            int y = (*points)[i].y;
 
             D2D1_ELLIPSE point = D2D1::Ellipse(D2D1::Point2F(x, y), 10, 10);
-            shared_ptr<MyEllipse> newEllipse = shared_ptr<MyEllipse>(new MyEllipse());
-            newEllipse->ellipse = point;
-            newEllipse->color = D2D1::ColorF(D2D1::ColorF::Green);
-            ellipses.insert(ellipses.end(), newEllipse);
+            AddEllipse(point, D2D1::ColorF(D2D1::ColorF::Green));
         }
 
         ConvexHull *hull = new ConvexHull(*points);
-        DrawConvexHull(hull->getHull(), D2D1::ColorF(D2D1::ColorF::White));
+        DrawConvexHull(pRenderTarget, hull->getHull(), D2D1::ColorF(D2D1::ColorF::White));
 
         hulls->push_back(hull);
 
         delete points;
 
-        for (auto i = ellipses.begin(); i != ellipses.end(); ++i)
-            (*i)->Draw(pRenderTarget, pBrush);
+        DrawEllipses(pRenderTarget, NULL);
 
         hr = pRenderTarget->EndDraw();
         if (FAILED(hr) || hr == D2DERR_RECREATE_TARGET)
@@ -574,18 +962,21 @@ void MainWindow::UpdateQuickhull() {
 
         for (auto i = ellipses.begin(); i != ellipses.end(); ++i)
         {
-            struct point p = { (*i)->ellipse.point.x, (*i)->ellipse.point.y };
+            struct point p = { i->ellipse.point.x, i->ellipse.point.y };
             points->push_back(p);
         }
 
-        ConvexHull* hull = new ConvexHull(*points);
-        DrawConvexHull(hull->getHull(), D2D1::ColorF(D2D1::ColorF::White));
-        (*hulls)[0] = hull;
+        struct hullJob job;
+        job.kind = HULL_JOB;
+        job.set1 = *points;
 
         delete points;
 
-        for (auto i = ellipses.begin(); i != ellipses.end(); ++i)
-            (*i)->Draw(pRenderTarget, pBrush);
+        const struct hullResult *result = Hulls(job);
+        DrawConvexHull(pRenderTarget, &result->hull1, D2D1::ColorF(D2D1::ColorF::White));
+        SetHull(0, result, &result->hull1);
+
+        DrawEllipses(pRenderTarget, NULL);
 
         hr = pRenderTarget->EndDraw();
         if (FAILED(hr) || hr == D2DERR_RECREATE_TARGET)
@@ -602,8 +993,9 @@ void MainWindow::PaintPointConvexHull()
     if (SUCCEEDED(hr))
     {
         PAINTSTRUCT ps;
-        ellipses.clear();
+        ClearEllipses();
         hulls->clear();
+        scenario++;
         BeginPaint(m_hwnd, &ps);
 
         pRenderTarget->BeginDraw();
@@ -614,38 +1006,32 @@ void MainWindow::PaintPointConvexHull()
         int rightLimit = rc.right - 200 - 500;
         int bottomLimit = rc.bottom - 200 - 150;
 
-        std::vector<struct point>* points = new std::vector<struct point>();
+        // The last point is the one tested against the hull of the others
+        std::vector<struct point>* points = new std::vector<struct point>(generatePoints(
+            makePointWorkload(UNIFORM_POINTS, scenario, { 500, 150 }, { 500.0 + rightLimit, 150.0 + bottomLimit }, true), 16));
+        struct point testPoint = points->back();
+        points->pop_back();
 
         for (int i = 0; i < 15; i++) {
-            int x = rand() % rightLimit + 500;
-            int y = rand() % bottomLimit + 150;
-
-            struct point p = { x, y };
-            points->push_back(p);
+            int x = (*points)[i].x;
+            int y = (*points)[i].y;
 
             D2D1_ELLIPSE point = D2D1::Ellipse(D2D1::Point2F(x, y), 1, 1);
-            shared_ptr<MyEllipse> newEllipse = shared_ptr<MyEllipse>(new MyEllipse());
-            newEllipse->ellipse = point;
-            newEllipse->color = D2D1::ColorF(D2D1::ColorF::Green);
-            ellipses.insert(ellipses.end(), newEllipse);
+            AddEllipse(point, D2D1::ColorF(D2D1::ColorF::Green));
         }
 
         ConvexHull* hull = new ConvexHull(*points);
-        DrawConvexHull(hull->getHull(), D2D1::ColorF(D2D1::ColorF::White));
+        DrawConvexHull(pRenderTarget, hull->getHull(), D2D1::ColorF(D2D1::ColorF::White));
         hulls->push_back(hull);
 
         delete points;
 
-        int x = rand() % rightLimit + 500;
-        int y = rand() % bottomLimit + 150;
-
-        struct point p = { x, y };
+        int x = testPoint.x;
+        int y = testPoint.y;
 
         D2D1_ELLIPSE point = D2D1::Ellipse(D2D1::Point2F(x, y), 10, 10);
-        shared_ptr<MyEllipse> newEllipse = shared_ptr<MyEllipse>(new MyEllipse());
-        newEllipse->ellipse = point;
-        newEllipse->color = D2D1::ColorF(D2D1::ColorF::Green);
-        ellipses.insert(ellipses.end(), newEllipse);
+        AddEllipse(point, D2D1::ColorF(D2D1::ColorF::Green));
+        MyEllipse *newEllipse = &ellipses.back();
 
         if (hull->containsPoint({ newEllipse->ellipse.point.x, newEllipse->ellipse.point.y })) {
             pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::White));
@@ -681,42 +1067,46 @@ void MainWindow::UpdatePointConvexHull() {
 
         for (auto i = ellipses.begin(); i != ellipses.end(); ++i)
         {
-            struct point p = { (*i)->ellipse.point.x, (*i)->ellipse.point.y };
+            struct point p = { i->ellipse.point.x, i->ellipse.point.y };
             points->push_back(p);
         }
 
         points->pop_back();
 
-        ConvexHull* hull = new ConvexHull(*points);
-        DrawConvexHull(hull->getHull(), D2D1::ColorF(D2D1::ColorF::White));
+        struct hullJob job;
+        job.kind = HULL_CONTAINS_JOB;
+        job.set1 = *points;
+        job.set2.push_back({ ellipses.back().ellipse.point.x, ellipses.back().ellipse.point.y });
 
-        (*hulls)[0] = hull;
+        const struct hullResult *result = Hulls(job);
+        DrawConvexHull(pRenderTarget, &result->hull1, D2D1::ColorF(D2D1::ColorF::White));
+        SetHull(0, result, &result->hull1);
 
-        if (hull->containsPoint({ ellipses.back()->ellipse.point.x, ellipses.back()->ellipse.point.y })) {
+        if (result->containsPoint) {
             inHull = true;
             if (mode == DragMode) {
                 pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::Yellow));
-                pRenderTarget->DrawEllipse(ellipses.back()->ellipse, pBrush, 5.0f);
+                pRenderTarget->DrawEllipse(ellipses.back().ellipse, pBrush, 5.0f);
                 pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::Red));
-                pRenderTarget->FillEllipse(ellipses.back()->ellipse, pBrush);
+                pRenderTarget->FillEllipse(ellipses.back().ellipse, pBrush);
             }
             else {
                 pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::White));
-                pRenderTarget->DrawEllipse(ellipses.back()->ellipse, pBrush, 5.0f);
+                pRenderTarget->DrawEllipse(ellipses.back().ellipse, pBrush, 5.0f);
                 pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::Red));
-                pRenderTarget->FillEllipse(ellipses.back()->ellipse, pBrush);
+                pRenderTarget->FillEllipse(ellipses.back().ellipse, pBrush);
             }
         }
         else {
             inHull = false;
             if (mode == DragMode) {
                 pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::Yellow));
-                pRenderTarget->DrawEllipse(ellipses.back()->ellipse, pBrush, 5.0f);
+                pRenderTarget->DrawEllipse(ellipses.back().ellipse, pBrush, 5.0f);
                 pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::Green));
-                pRenderTarget->FillEllipse(ellipses.back()->ellipse, pBrush);
+                pRenderTarget->FillEllipse(ellipses.back().ellipse, pBrush);
             }
             else {
-                ellipses.back()->Draw(pRenderTarget, pBrush);
+                ellipses.back().Draw(pRenderTarget, pBrush);
             }
         }
 
@@ -741,6 +1131,8 @@ void MainWindow::Resize()
         D2D1_SIZE_U size = D2D1::SizeU(rc.right, rc.bottom);
 
         pRenderTarget->Resize(size);
+        SafeRelease(&pStaticLayer);
+        layerMovingHull = -1;
 
         InvalidateRect(m_hwnd, NULL, FALSE);
     }
@@ -771,10 +1163,9 @@ void MainWindow::OnLButtonDown(int pixelX, int pixelY, DWORD flags)
         ptMouse.y = dipY;
         temp->clear();
         for (int i = 0; i < ellipses.size() / 2; i++) {
-            auto iterator = ellipses.begin();
-            std::advance(iterator, i);
+            MyEllipse *current = &ellipses[i];
 
-            struct point p = { (*iterator)->ellipse.point.x, (*iterator)->ellipse.point.y };
+            struct point p = { current->ellipse.point.x, current->ellipse.point.y };
             temp->push_back(p);
         }
         SetMode(DragHull1);
@@ -788,10 +1179,9 @@ void MainWindow::OnLButtonDown(int pixelX, int pixelY, DWORD flags)
         temp->clear();
         originOriginal = origin;
         for (int i = ellipses.size() / 2; i < ellipses.size(); i++) {
-            auto iterator = ellipses.begin();
-            std::advance(iterator, i);
+            MyEllipse *current = &ellipses[i];
 
-            struct point p = { (*iterator)->ellipse.point.x, (*iterator)->ellipse.point.y };
+            struct point p = { current->ellipse.point.x, current->ellipse.point.y };
             temp->push_back(p);
         }
         SetMode(DragHull1);
@@ -805,7 +1195,7 @@ void MainWindow::OnLButtonDown(int pixelX, int pixelY, DWORD flags)
         originOriginal = origin;
         temp->clear();
         for (auto i = ellipses.begin(); i != ellipses.end(); i++) {
-            temp->push_back({ (*i)->ellipse.point.x, (*i)->ellipse.point.y });
+            temp->push_back({ i->ellipse.point.x, i->ellipse.point.y });
         }
         SetMode(DragScreen);
     }
@@ -815,7 +1205,7 @@ void MainWindow::OnLButtonDown(int pixelX, int pixelY, DWORD flags)
         ptMouse.y = dipY;
         temp->clear();
         for (auto i = ellipses.begin(); i != ellipses.end(); i++) {
-            struct point p = { (*i)->ellipse.point.x, (*i)->ellipse.point.y };
+            struct point p = { i->ellipse.point.x, i->ellipse.point.y };
             temp->push_back(p);
         }
         SetMode(DragHull2);
@@ -831,14 +1221,14 @@ void MainWindow::OnLButtonUp()
         SetMode(SelectMode);
         pRenderTarget->BeginDraw();
         pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::White));
-        pRenderTarget->DrawEllipse(ellipses.back()->ellipse, pBrush, 5.0f);
+        pRenderTarget->DrawEllipse(ellipses.back().ellipse, pBrush, 5.0f);
         if (inHull && paintMode == POINT_CONVEX_HULL) {
             pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::Red));
         }
         else {
             pBrush->SetColor(D2D1::ColorF(D2D1::ColorF::Green));
         }
-        pRenderTarget->FillEllipse(ellipses.back()->ellipse, pBrush);
+        pRenderTarget->FillEllipse(ellipses.back().ellipse, pBrush);
         pRenderTarget->EndDraw();
     }
     else if (mode == DragScreen) {
@@ -848,6 +1238,8 @@ void MainWindow::OnLButtonUp()
         SetMode(SelectMode);
     }
 
+    // The static layer only lasts for one drag; the next one starts from a fresh layer
+    layerMovingHull = -1;
     ReleaseCapture(); 
 }
 
@@ -863,6 +1255,7 @@ void MainWindow::OnMouseMove(int pixelX, int pixelY, DWORD flags)
             // Move the ellipse.
             Selection()->ellipse.point.x = dipX + ptMouse.x;
             Selection()->ellipse.point.y = dipY + ptMouse.y;
+            EllipseMoved(ellipses.indexOf(selection));
         }
         InvalidateRect(m_hwnd, NULL, FALSE);
     }
@@ -871,41 +1264,33 @@ void MainWindow::OnMouseMove(int pixelX, int pixelY, DWORD flags)
         yOffset = (dipY - ptMouse.y);
         int j = 0;
 
-        if (hullSelected == 0) {
-            for (int i = 0; i < ellipses.size() / 2; i++) {
-                auto iterator = ellipses.begin();
-                std::advance(iterator, i);
-
-                (*iterator)->ellipse.point.x = (*temp)[j].x + xOffset;
-                (*iterator)->ellipse.point.y = (*temp)[j].y + yOffset;
-                j++;
-            }
-        }
-        else {
-            for (int i = ellipses.size() / 2; i < ellipses.size(); i++) {
-                auto iterator = ellipses.begin();
-                std::advance(iterator, i);
-
-                (*iterator)->ellipse.point.x = (*temp)[j].x + xOffset;
-                (*iterator)->ellipse.point.y = (*temp)[j].y + yOffset;
-                j++;
-            }
+        int first = hullSelected == 0 ? 0 : ellipses.size() / 2;
+        int last = hullSelected == 0 ? ellipses.size() / 2 : ellipses.size();
+        for (int i = first; i < last; i++) {
+            ellipses[i].ellipse.point.x = (*temp)[j].x + xOffset;
+            ellipses[i].ellipse.point.y = (*temp)[j].y + yOffset;
+            EllipseMoved(i);
+            j++;
         }
 
-        SendMessage(m_hwnd, WM_PAINT, NULL, NULL);
+        /* Invalidating instead of sending WM_PAINT coalesces a burst of mouse moves: Windows only
+         * generates WM_PAINT once the queue is empty, and EndDraw waits for the vertical blank,
+         * so dragging repaints at most once per display refresh */
+        InvalidateRect(m_hwnd, NULL, FALSE);
     }
     else if (flags & MK_LBUTTON && mode == DragHull2) {
         xOffset = (dipX - ptMouse.x);
         yOffset = (dipY - ptMouse.y);
         int j = 0;
 
-        for (auto i = ellipses.begin(); i != ellipses.end(); i++) {
-            (*i)->ellipse.point.x = (*temp)[j].x + xOffset;
-            (*i)->ellipse.point.y = (*temp)[j].y + yOffset;
+        for (int i = 0; i < ellipses.size(); i++) {
+            ellipses[i].ellipse.point.x = (*temp)[j].x + xOffset;
+            ellipses[i].ellipse.point.y = (*temp)[j].y + yOffset;
+            EllipseMoved(i);
             j++;
         }
 
-        SendMessage(m_hwnd, WM_PAINT, NULL, NULL);
+        InvalidateRect(m_hwnd, NULL, FALSE);
     }
     else if (flags & MK_LBUTTON && mode == DragScreen) {
         xOffset = (dipX - ptMouse.x);
@@ -919,27 +1304,42 @@ void MainWindow::OnMouseMove(int pixelX, int pixelY, DWORD flags)
         conv->setOrigin(origin.x, origin.y);
 
         int j = 0;
-        for (auto i = ellipses.begin(); i != ellipses.end(); i++) {
-            (*i)->ellipse.point.x = (*temp)[j].x + xOffset;
-            (*i)->ellipse.point.y = (*temp)[j].y + yOffset;
+        for (int i = 0; i < ellipses.size(); i++) {
+            ellipses[i].ellipse.point.x = (*temp)[j].x + xOffset;
+            ellipses[i].ellipse.point.y = (*temp)[j].y + yOffset;
+            EllipseMoved(i);
             j++;
         }
 
-        SendMessage(m_hwnd, WM_PAINT, NULL, NULL);
+        InvalidateRect(m_hwnd, NULL, FALSE);
     }
 }
 
+/* Picks the topmost (last drawn) ellipse under the point, looking only at the grid cell it falls in */
 BOOL MainWindow::HitTest(float x, float y)
 {
-    for (auto i = ellipses.rbegin(); i != ellipses.rend(); ++i)
+    const std::vector<int> *candidates = pointIndex.candidates({ x, y });
+    if (candidates == NULL)
+    {
+        return FALSE;
+    }
+
+    int best = -1;
+    for (int i = 0; i < candidates->size(); i++)
     {
-        if ((*i)->HitTest(x, y))
+        int index = ellipses.indexOf((*candidates)[i]);
+        if (index > best && ellipses[index].HitTest(x, y))
         {
-            selection = (++i).base();
-            return TRUE;
+            best = index;
         }
     }
-    return FALSE;
+
+    if (best == -1)
+    {
+        return FALSE;
+    }
+    selection = ellipses.handleAt(best);
+    return TRUE;
 }
 
 void MainWindow::MoveSelection(float x, float y)
@@ -948,10 +1348,37 @@ void MainWindow::MoveSelection(float x, float y)
     {
         Selection()->ellipse.point.x += x;
         Selection()->ellipse.point.y += y;
+        EllipseMoved(ellipses.indexOf(selection));
         InvalidateRect(m_hwnd, NULL, FALSE);
     }
 }
 
+void MainWindow::AddEllipse(D2D1_ELLIPSE ellipse, D2D1_COLOR_F color)
+{
+    MyEllipse newEllipse;
+    newEllipse.ellipse = ellipse;
+    newEllipse.color = color;
+    int handle = ellipses.add(newEllipse);
+    pointIndex.update(handle, { ellipse.point.x, ellipse.point.y }, ellipse.radiusX, ellipse.radiusY);
+    ellipseBatchesStale = true;
+}
+
+void MainWindow::ClearEllipses()
+{
+    ellipses.clear();
+    pointIndex.clear();
+    ClearSelection();
+    ellipseBatchesStale = true;
+}
+
+/* Must be called whenever the position or radius of ellipses[index] changes */
+void MainWindow::EllipseMoved(int index)
+{
+    D2D1_ELLIPSE e = ellipses[index].ellipse;
+    pointIndex.update(ellipses.handleAt(index), { e.point.x, e.point.y }, e.radiusX, e.radiusY);
+    ellipseBatchesStale = true;
+}
+
 void MainWindow::SetMode(Mode m)
 {
     mode = m;
@@ -1074,8 +1501,43 @@ void MainWindow::OnMouseScroll(int wheelData) {
     }
 }
 
+/* ConvexHullAlgorithms.exe /soak [seconds] [seed] runs the verifier's soak test instead of
+ * opening the window, printing to the console it was started from (start /wait from cmd to get
+ * the exit code). Exits with 1 if any check on the newer code failed; the original code's known
+ * failures are only counted. Returns false if the command line doesn't ask for a soak. */
+static bool RunSoakCommand(int *exitCode)
+{
+    int argc;
+    LPWSTR *argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (argv == NULL)
+        return false;
+    if (argc < 2 || (wcscmp(argv[1], L"/soak") != 0 && wcscmp(argv[1], L"--soak") != 0))
+    {
+        LocalFree(argv);
+        return false;
+    }
+
+    double seconds = argc > 2 ? _wtof(argv[2]) : 60;
+    uint64_t seed = argc > 3 ? _wcstoui64(argv[3], NULL, 10) : 1;
+    LocalFree(argv);
+
+    if (!AttachConsole(ATTACH_PARENT_PROCESS))
+        AllocConsole();
+    FILE *log = NULL;
+    freopen_s(&log, "CONOUT$", "w", stdout);
+
+    struct verifyStats stats = runSoak(seconds, seed, 10, stdout);
+    fflush(stdout);
+    *exitCode = stats.failures > 0 ? 1 : 0;
+    return true;
+}
+
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE, PWSTR, int nCmdShow)
 {
+    int exitCode;
+    if (RunSoakCommand(&exitCode))
+        return exitCode;
+
     MainWindow win;
 
     if (!win.Create(L"Convex Hull Algorithms", WS_OVERLAPPEDWINDOW | WS_CLIPCHILDREN))
@@ -1111,10 +1573,14 @@ LRESULT MainWindow::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
         RECT rc;
         GetClientRect(m_hwnd, &rc);
         conv = new Converter(rc.right, rc.bottom);
+        worker = new HullWorker([this]() { PostMessage(m_hwnd, WM_HULL_READY, 0, 0); });
         return 0;
 
     case WM_DESTROY:
+        delete worker;
+        worker = NULL;
         DiscardGraphicsResources();
+        DiscardGeometry();
         SafeRelease(&pFactory);
         PostQuitMessage(0);
         return 0;
@@ -1127,6 +1593,10 @@ LRESULT MainWindow::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam)
         Resize();
         return 0;
 
+    case WM_HULL_READY:
+        InvalidateRect(m_hwnd, NULL, FALSE);
+        return 0;
+
     case WM_LBUTTONDOWN: 
         OnLButtonDown(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), (DWORD)wParam);
         return 0;